@@ -0,0 +1,108 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace microbenchmark
+{
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::nanoseconds;
+
+    // Keeps the compiler from dropping a computation whose result is otherwise unused.
+    template<typename T>
+    void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sSink;
+        sSink = &value;
+#endif
+    }
+
+    struct Options
+    {
+        std::string mFilter;
+        Duration mMinimumBatchTime{ std::chrono::milliseconds{ 20 } };
+        int32_t mBatches{ 7 };
+    };
+
+    struct Result
+    {
+        std::string mName;
+        double mNanosecondsPerOperation{};
+        std::optional<double> mBytesPerSecond;
+    };
+
+    void PrintHeader(std::ostream& outStream)
+    {
+        outStream << std::left << std::setw(40) << "Benchmark" << std::right
+            << std::setw(14) << "ns/op" << std::setw(14) << "MB/s" << std::setw(14) << "iterations" << '\n';
+    }
+
+    // Runs the operation in batches, the batch size grows until a batch takes the minimum batch time.
+    // Reports the fastest batch, the others only lost time to noise. The operation gets the iteration index,
+    // so it can cycle through prepared inputs. Bytes per operation turns the time into a throughput.
+    class Runner
+    {
+    public:
+        explicit Runner(Options options) : mOptions{ std::move(options) } {}
+
+        template<typename Operation>
+        void Run(std::string_view name, Operation&& operation, std::optional<double> bytesPerOperation = {})
+        {
+            if (!mOptions.mFilter.empty() && name.find(mOptions.mFilter) == std::string_view::npos)
+            {
+                return;
+            }
+
+            const auto runBatch = [&operation](uint64_t iterations)
+                {
+                    const auto start{ Clock::now() };
+                    for (uint64_t iteration = 0; iteration < iterations; iteration++)
+                    {
+                        operation(iteration);
+                    }
+                    return std::chrono::duration_cast<Duration>(Clock::now() - start);
+                };
+
+            uint64_t iterations{ 1 };
+            while (runBatch(iterations) < mOptions.mMinimumBatchTime && iterations < (uint64_t{ 1 } << 40))
+            {
+                iterations *= 2;
+            }
+
+            Duration fastestBatch{ Duration::max() };
+            for (int32_t batch = 0; batch < mOptions.mBatches; batch++)
+            {
+                fastestBatch = std::min(fastestBatch, runBatch(iterations));
+            }
+
+            Result result{ std::string{ name }, static_cast<double>(fastestBatch.count()) / iterations, {} };
+            if (bytesPerOperation)
+            {
+                result.mBytesPerSecond = *bytesPerOperation / result.mNanosecondsPerOperation * 1e9;
+            }
+
+            std::cout << std::left << std::setw(40) << result.mName << std::right << std::fixed << std::setprecision(2)
+                << std::setw(14) << result.mNanosecondsPerOperation << std::setw(14);
+            if (result.mBytesPerSecond)
+            {
+                std::cout << *result.mBytesPerSecond / (1024.0 * 1024.0);
+            }
+            else
+            {
+                std::cout << "-";
+            }
+            std::cout << std::setw(14) << iterations << std::defaultfloat << '\n';
+        }
+
+    private:
+        Options mOptions;
+    };
+}
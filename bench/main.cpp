@@ -0,0 +1,216 @@
+#include "MicroBenchmark.h"
+#include "BitGrid.h"
+#include "Grid.h"
+#include "Utility.h"
+
+#include <array>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Microbenchmarks of the utility primitives every day sits on, on inputs generated from a fixed seed.
+// Usage: AOC24Bench [filter], only benchmarks whose name contains the filter are run.
+
+namespace
+{
+    // inputs are cycled through with the iteration index, a power of two keeps that a mask
+    static constexpr size_t sInputCount{ 4096 };
+    static constexpr size_t sInputMask{ sInputCount - 1 };
+    static constexpr uint64_t sSeed{ 1 };
+
+    [[nodiscard]] std::vector<std::string> GenerateNumberStrings(generator::Random& random, int64_t maximum, bool allowNegative)
+    {
+        std::vector<std::string> result;
+        result.reserve(sInputCount);
+        for (size_t index = 0; index < sInputCount; index++)
+        {
+            const auto number{ random.Uniform(0, maximum) };
+            result.push_back(std::to_string(allowNegative && random.Chance(50) ? -number : number));
+        }
+
+        return result;
+    }
+
+    // Lines like the ones of day 13 and day 14, the numbers GetNumbers has to find are surrounded by text.
+    [[nodiscard]] std::vector<std::string> GenerateNumberLines(generator::Random& random)
+    {
+        std::vector<std::string> result;
+        result.reserve(sInputCount);
+        for (size_t index = 0; index < sInputCount; index++)
+        {
+            result.push_back("p=" + std::to_string(random.Uniform(0, 100)) + "," + std::to_string(random.Uniform(0, 102))
+                + " v=" + std::to_string(random.Uniform(-99, 99)) + "," + std::to_string(random.Uniform(-99, 99)));
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] double GetAverageSize(const std::vector<std::string>& strings)
+    {
+        return std::accumulate(strings.begin(), strings.end(), 0.0, [](double sum, const std::string& string) { return sum + string.size(); }) / strings.size();
+    }
+
+    void BenchmarkParsing(microbenchmark::Runner& runner)
+    {
+        generator::Random random{ sSeed };
+        const auto smallNumbers{ GenerateNumberStrings(random, 99, false) };
+        const auto numbers{ GenerateNumberStrings(random, 999'999'999, false) };
+        const auto signedNumbers{ GenerateNumberStrings(random, 999'999, true) };
+        const auto longNumbers{ GenerateNumberStrings(random, 999'999'999'999'999, false) };
+        const auto lines{ GenerateNumberLines(random) };
+
+        runner.Run("ToNumber<int32_t> 1-2 digits", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ToNumber<int32_t>(smallNumbers[iteration & sInputMask])); },
+            GetAverageSize(smallNumbers));
+        runner.Run("ToNumber<int64_t> 1-9 digits", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ToNumber<int64_t>(numbers[iteration & sInputMask])); },
+            GetAverageSize(numbers));
+        runner.Run("ToNumber<uint64_t> 1-15 digits", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ToNumber<uint64_t>(longNumbers[iteration & sInputMask])); },
+            GetAverageSize(longNumbers));
+        runner.Run("ToNumber<int32_t> signed", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ToNumber<int32_t>(signedNumbers[iteration & sInputMask])); },
+            GetAverageSize(signedNumbers));
+        runner.Run("ToNumber<int32_t> char", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ToNumber<int32_t>(numbers[iteration & sInputMask].front())); },
+            1.0);
+        runner.Run("GetNumbers<int32_t> line", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::GetNumbers<int32_t>(lines[iteration & sInputMask])); },
+            GetAverageSize(lines));
+        std::array<int32_t, 16> scanBuffer{};
+        runner.Run("ScanNumbers<int32_t> line", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::ScanNumbers(lines[iteration & sInputMask], std::span{ scanBuffer })); },
+            GetAverageSize(lines));
+
+        const auto text{ generator::JoinLines(lines) };
+        runner.Run("GetStringSplitBy 4096 lines", [&](uint64_t) { microbenchmark::DoNotOptimize(utility::GetStringSplitBy(text)); },
+            static_cast<double>(text.size()));
+    }
+
+    void BenchmarkArithmetic(microbenchmark::Runner& runner)
+    {
+        generator::Random random{ sSeed };
+        std::vector<uint64_t> numbers(sInputCount);
+        std::ranges::generate(numbers, [&random] { return static_cast<uint64_t>(random.Uniform(1, 999'999'999'999)); });
+        std::vector<uint64_t> smallNumbers(sInputCount);
+        std::ranges::generate(smallNumbers, [&random] { return static_cast<uint64_t>(random.Uniform(1, 9'999)); });
+
+        runner.Run("GetNumberOfDigitsByDivision", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::GetNumberOfDigitsByDivision(numbers[iteration & sInputMask])); });
+        runner.Run("GetNumberOfDigitsByLog10", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::GetNumberOfDigitsByLog10(numbers[iteration & sInputMask])); });
+        runner.Run("GetNumberOfDigitsByString", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::GetNumberOfDigitsByString(numbers[iteration & sInputMask])); });
+        runner.Run("Concatenate<uint64_t>", [&](uint64_t iteration)
+            {
+                microbenchmark::DoNotOptimize(utility::Concatenate(smallNumbers[iteration & sInputMask], smallNumbers[(iteration + 1) & sInputMask]));
+            });
+    }
+
+    void BenchmarkGrid(microbenchmark::Runner& runner)
+    {
+        using Position = utility::Position<int32_t>;
+        static constexpr int32_t sSide{ 140 };
+
+        generator::Random random{ sSeed };
+        // a border of two, so the neighbours of the positions just outside can be read without a bounds check
+        utility::Grid<int32_t> grid{ sSide, sSide, 0, 2, 0 };
+        for (auto row : grid.GetRows())
+        {
+            std::ranges::generate(row, [&random] { return static_cast<int32_t>(random.Uniform(0, 9)); });
+        }
+
+        // a few positions are just outside, like the neighbours of border cells
+        std::vector<Position> positions(sInputCount);
+        std::ranges::generate(positions, [&random] { return Position{ static_cast<int32_t>(random.Uniform(-1, sSide)), static_cast<int32_t>(random.Uniform(-1, sSide)) }; });
+        std::vector<utility::Grid<int32_t>::Index> indices(sInputCount);
+        std::ranges::transform(positions, indices.begin(), [&grid](Position position) { return grid.GetIndex(position); });
+
+        static constexpr std::array sDirections{ utility::Direction::left, utility::Direction::right, utility::Direction::up, utility::Direction::down,
+            utility::Direction::leftUp, utility::Direction::leftDown, utility::Direction::rightUp, utility::Direction::rightDown };
+
+        runner.Run("Grid position access", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(grid[positions[iteration & sInputMask]]); });
+        runner.Run("GetDirectionData", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(utility::GetDirectionData(sDirections[iteration & 7])); });
+        runner.Run("Position += and *", [&](uint64_t iteration)
+            {
+                auto position{ positions[iteration & sInputMask] };
+                position += positions[(iteration + 1) & sInputMask];
+                microbenchmark::DoNotOptimize(position * 3);
+            });
+        runner.Run("Position neighbours via Grid", [&](uint64_t iteration)
+            {
+                int32_t sum{};
+                auto position{ positions[iteration & sInputMask] };
+                utility::ForEachNeighbor<utility::sFullDirections>(position, [&](utility::Direction, Position neighbour)
+                    {
+                        if (grid.IsInside(neighbour))
+                        {
+                            sum += grid[neighbour];
+                        }
+                    });
+                microbenchmark::DoNotOptimize(sum);
+            });
+
+        runner.Run("Index neighbours via Grid border", [&](uint64_t iteration)
+            {
+                int32_t sum{};
+                const auto index{ indices[iteration & sInputMask] };
+                utility::ForEachNeighbor<utility::sFullDirections>(index, grid.GetStride(), [&](utility::Direction, utility::Grid<int32_t>::Index neighbour)
+                    {
+                        sum += grid[neighbour];
+                    });
+                microbenchmark::DoNotOptimize(sum);
+            });
+    }
+
+    void BenchmarkBitGrid(microbenchmark::Runner& runner)
+    {
+        using Position = utility::Position<int32_t>;
+        static constexpr int32_t sSide{ 140 };
+
+        generator::Random random{ sSeed };
+        std::vector<Position> positions(sInputCount);
+        std::ranges::generate(positions, [&random] { return Position{ static_cast<int32_t>(random.Uniform(0, sSide - 1)), static_cast<int32_t>(random.Uniform(0, sSide - 1)) }; });
+
+        utility::BitGrid<> bitGrid{ sSide, sSide };
+        for (const auto position : positions)
+        {
+            bitGrid.Set(position);
+        }
+
+        runner.Run("BitGrid TestAndSet", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(bitGrid.TestAndSet(positions[iteration & sInputMask])); });
+        runner.Run("BitGrid TestAndSetAtomic", [&](uint64_t iteration) { microbenchmark::DoNotOptimize(bitGrid.TestAndSetAtomic(positions[iteration & sInputMask])); });
+        runner.Run("BitGrid Count", [&](uint64_t) { microbenchmark::DoNotOptimize(bitGrid.Count()); });
+        runner.Run("BitGrid ShiftRow", [&](uint64_t iteration)
+            {
+                bitGrid.ShiftRow(static_cast<int32_t>(iteration % sSide), (iteration & 1) ? 1 : -1);
+                microbenchmark::DoNotOptimize(bitGrid.GetRow(0).front());
+            });
+        runner.Run("BitGrid Clear", [&](uint64_t)
+            {
+                bitGrid.Clear();
+                microbenchmark::DoNotOptimize(bitGrid.GetRow(0).front());
+            });
+
+        // what the bit grid replaces, rows of their own cleared and resized
+        std::vector<std::vector<bool>> boolGrid(sSide, std::vector<bool>(sSide, false));
+        runner.Run("vector<vector<bool>> clear and resize", [&](uint64_t)
+            {
+                for (auto& row : boolGrid)
+                {
+                    row.clear();
+                    row.resize(sSide, false);
+                }
+                microbenchmark::DoNotOptimize(boolGrid.front().front());
+            });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    microbenchmark::Options options;
+    if (argc > 1)
+    {
+        options.mFilter = argv[1];
+    }
+
+    microbenchmark::Runner runner{ options };
+    microbenchmark::PrintHeader(std::cout);
+    BenchmarkParsing(runner);
+    BenchmarkArithmetic(runner);
+    BenchmarkGrid(runner);
+    BenchmarkBitGrid(runner);
+    return 0;
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include "Utility.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <optional>
+#include <span>
+
+namespace utility
+{
+    // Built with AOC24_TRACK_ALLOCATIONS the global operator new and delete are replaced to count every heap allocation.
+    // It's a build option as the bookkeeping slows down every allocation and with that the timings.
+#ifdef AOC24_TRACK_ALLOCATIONS
+    static constexpr bool sIsAllocationTrackingEnabled{ true };
+#else
+    static constexpr bool sIsAllocationTrackingEnabled{ false };
+#endif
+
+    // Heap use of a measured region. The peak is the high-water mark of the live heap above what was live when the region started.
+    struct AllocationStatistics
+    {
+        double mAllocationCount{};
+        double mAllocatedBytes{};
+        int64_t mPeakLiveBytes{};
+    };
+
+    namespace allocation
+    {
+        struct Counters
+        {
+            std::atomic<uint64_t> mAllocationCount{ 0 };
+            std::atomic<uint64_t> mAllocatedBytes{ 0 };
+            std::atomic<int64_t> mLiveBytes{ 0 };
+            std::atomic<int64_t> mPeakLiveBytes{ 0 };
+        };
+
+        // constant initialized, allocations of other statics can happen before dynamic initialization
+        static constinit Counters sCounters;
+
+        void RecordAllocation(size_t size)
+        {
+            sCounters.mAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            sCounters.mAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+            const auto liveBytes{ sCounters.mLiveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size) };
+            auto peakLiveBytes{ sCounters.mPeakLiveBytes.load(std::memory_order_relaxed) };
+            while (liveBytes > peakLiveBytes && !sCounters.mPeakLiveBytes.compare_exchange_weak(peakLiveBytes, liveBytes, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void RecordDeallocation(size_t size)
+        {
+            sCounters.mLiveBytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+        }
+
+        // Stored right in front of every block, delete gets neither the size nor, for unaligned blocks, the alignment.
+        struct BlockHeader
+        {
+            void* mAllocation;
+            size_t mSize;
+        };
+
+        [[nodiscard]] void* Allocate(size_t size, size_t alignment) noexcept
+        {
+            alignment = std::max(alignment, alignof(BlockHeader));
+            // the padded size would wrap around and malloc hand out a tiny block
+            if (size > std::numeric_limits<size_t>::max() - sizeof(BlockHeader) - alignment)
+            {
+                return nullptr;
+            }
+
+            auto* allocation{ static_cast<std::byte*>(std::malloc(sizeof(BlockHeader) + alignment - 1 + std::max<size_t>(size, 1))) };
+            if (!allocation)
+            {
+                return nullptr;
+            }
+
+            const auto firstUsable{ reinterpret_cast<uintptr_t>(allocation + sizeof(BlockHeader)) };
+            auto* block{ reinterpret_cast<std::byte*>((firstUsable + alignment - 1) / alignment * alignment) };
+            *(reinterpret_cast<BlockHeader*>(block) - 1) = { allocation, size };
+            RecordAllocation(size);
+            return block;
+        }
+
+        void Deallocate(void* block) noexcept
+        {
+            if (!block)
+            {
+                return;
+            }
+
+            const auto header{ *(static_cast<BlockHeader*>(block) - 1) };
+            RecordDeallocation(header.mSize);
+            std::free(header.mAllocation);
+        }
+
+        [[nodiscard]] void* AllocateOrThrow(size_t size, size_t alignment)
+        {
+            if (auto* block{ Allocate(size, alignment) })
+            {
+                return block;
+            }
+
+            throw std::bad_alloc{};
+        }
+    }
+
+    // Snapshot at the start of a region, Stop returns what happened since.
+    class AllocationScope
+    {
+    public:
+        AllocationScope()
+        {
+            auto& counters{ allocation::sCounters };
+            mAllocationCount = counters.mAllocationCount.load(std::memory_order_relaxed);
+            mAllocatedBytes = counters.mAllocatedBytes.load(std::memory_order_relaxed);
+            mLiveBytes = counters.mLiveBytes.load(std::memory_order_relaxed);
+            counters.mPeakLiveBytes.store(mLiveBytes, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] AllocationStatistics Stop() const
+        {
+            const auto& counters{ allocation::sCounters };
+            return { static_cast<double>(counters.mAllocationCount.load(std::memory_order_relaxed) - mAllocationCount),
+                static_cast<double>(counters.mAllocatedBytes.load(std::memory_order_relaxed) - mAllocatedBytes),
+                counters.mPeakLiveBytes.load(std::memory_order_relaxed) - mLiveBytes };
+        }
+
+    private:
+        uint64_t mAllocationCount{};
+        uint64_t mAllocatedBytes{};
+        int64_t mLiveBytes{};
+    };
+
+    // Mean allocations and bytes per sample, the highest peak.
+    [[nodiscard]] AllocationStatistics AverageAllocationStatistics(std::span<const AllocationStatistics> samples)
+    {
+        AllocationStatistics result;
+        if (samples.empty())
+        {
+            return result;
+        }
+
+        for (const auto& sample : samples)
+        {
+            result.mAllocationCount += sample.mAllocationCount;
+            result.mAllocatedBytes += sample.mAllocatedBytes;
+            result.mPeakLiveBytes = std::max(result.mPeakLiveBytes, sample.mPeakLiveBytes);
+        }
+        result.mAllocationCount /= samples.size();
+        result.mAllocatedBytes /= samples.size();
+        return result;
+    }
+
+    void PrintAllocationsHeader(std::ostream& outStream)
+    {
+        outStream << std::left << std::setw(16) << "Phase" << std::right
+            << std::setw(14) << "allocations" << std::setw(16) << "bytes" << std::setw(16) << "peak bytes" << "  (mean, peak is the maximum)\n";
+    }
+
+    void PrintAllocations(std::ostream& outStream, Phase phase, const AllocationStatistics& statistics)
+    {
+        outStream << std::left << std::setw(16) << sPhaseStringMap.at(phase) << std::right << std::fixed << std::setprecision(0)
+            << std::setw(14) << statistics.mAllocationCount << std::setw(16) << statistics.mAllocatedBytes
+            << std::setw(16) << statistics.mPeakLiveBytes << std::defaultfloat << '\n';
+    }
+}
+
+#ifdef AOC24_TRACK_ALLOCATIONS
+// The nothrow, array and sized forms are replaced as well, the library versions don't all forward to the plain ones.
+void* operator new(size_t size)
+{
+    return utility::allocation::AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](size_t size)
+{
+    return utility::allocation::AllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return utility::allocation::AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return utility::allocation::AllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return utility::allocation::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return utility::allocation::Allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return utility::allocation::Allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return utility::allocation::Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    utility::allocation::Deallocate(block);
+}
+#endif
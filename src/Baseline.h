@@ -0,0 +1,207 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <span>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace utility
+{
+    // Identifies a phase of a day in a baseline: day, input version and phase names.
+    using BaselineKey = std::tuple<std::string, std::string, std::string>;
+    using Baseline = std::map<BaselineKey, std::vector<Duration>>;
+
+    struct RegressionOptions
+    {
+        std::filesystem::path mSaveBaselinePath;
+        std::filesystem::path mCompareBaselinePath;
+        double mSignificance{ 0.01 };
+        double mMinimumSlowdown{ 1.05 };
+    };
+
+    [[nodiscard]] BaselineKey GetBaselineKey(const BenchmarkRecord& record)
+    {
+        return { std::string{ record.mDay }, std::string{ sInputVersionStringMap.at(record.mInputVersion) }, std::string{ sPhaseStringMap.at(record.mPhase) } };
+    }
+
+    // One line per record: day,input version,phase,space separated samples in nanoseconds.
+    [[nodiscard]] bool SaveBaseline(const std::filesystem::path& path, const std::vector<BenchmarkRecord>& records)
+    {
+        std::ofstream outStream{ path };
+        if (!outStream)
+        {
+            return false;
+        }
+
+        for (const auto& record : records)
+        {
+            const auto [day, inputVersion, phase] {GetBaselineKey(record)};
+            outStream << day << ',' << inputVersion << ',' << phase << ',';
+            for (const auto [index, sample] : record.mSamples | std::ranges::views::enumerate)
+            {
+                outStream << (index == 0 ? "" : " ") << sample.count();
+            }
+            outStream << '\n';
+        }
+
+        return static_cast<bool>(outStream);
+    }
+
+    [[nodiscard]] std::expected<Baseline, std::string> LoadBaseline(const std::filesystem::path& path)
+    {
+        std::ifstream inStream{ path };
+        if (!inStream)
+        {
+            return std::unexpected{ std::string{ "couldn't open baseline " }.append(path.string()) };
+        }
+
+        using namespace std::literals;
+        Baseline result;
+        std::string line;
+        while (std::getline(inStream, line))
+        {
+            if (line.empty())
+            {
+                continue;
+            }
+
+            std::vector<std::string_view> fields;
+            for (const auto field : line | std::ranges::views::split(","sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+            {
+                fields.push_back(field);
+            }
+
+            if (fields.size() != 4)
+            {
+                return std::unexpected{ std::string{ "malformed baseline line: " }.append(line) };
+            }
+
+            auto& samples{ result[BaselineKey{ fields[0], fields[1], fields[2] }] };
+            for (const auto sample : fields[3] | std::ranges::views::split(" "sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+            {
+                Duration::rep value{};
+                if (const auto [end, errorCode] {std::from_chars(sample.data(), sample.data() + sample.size(), value)}; errorCode != std::errc{} || end != sample.data() + sample.size())
+                {
+                    return std::unexpected{ std::string{ "malformed baseline sample: " }.append(sample) };
+                }
+                samples.emplace_back(value);
+            }
+        }
+
+        return result;
+    }
+
+    struct MannWhitneyResult
+    {
+        double mU;
+        double mZ;
+        double mPValue;     // one sided, probability of seeing samples this slow if nothing changed
+    };
+
+    // One sided Mann-Whitney U test of the current samples being slower than the baseline samples.
+    // Uses the normal approximation with tie and continuity correction.
+    [[nodiscard]] MannWhitneyResult MannWhitneyUTest(std::span<const Duration> baselineSamples, std::span<const Duration> currentSamples)
+    {
+        const double baselineCount{ static_cast<double>(baselineSamples.size()) };
+        const double currentCount{ static_cast<double>(currentSamples.size()) };
+        if (baselineSamples.empty() || currentSamples.empty())
+        {
+            return { 0.0, 0.0, 1.0 };
+        }
+
+        // pair of sample and whether it's from the current run
+        std::vector<std::pair<Duration, bool>> combined;
+        combined.reserve(baselineSamples.size() + currentSamples.size());
+        std::ranges::transform(baselineSamples, std::back_inserter(combined), [](Duration sample) {return std::pair{ sample, false }; });
+        std::ranges::transform(currentSamples, std::back_inserter(combined), [](Duration sample) {return std::pair{ sample, true }; });
+        std::ranges::sort(combined, std::less<>{}, &std::pair<Duration, bool>::first);
+
+        double currentRankSum{};
+        double tieCorrection{};
+        for (size_t first = 0; first < combined.size();)
+        {
+            size_t last{ first };
+            while (last + 1 < combined.size() && combined[last + 1].first == combined[first].first)
+            {
+                ++last;
+            }
+
+            // ranks are 1 based, tied samples share the average of their ranks
+            const double averageRank{ (first + last) / 2.0 + 1.0 };
+            const double tiedCount{ static_cast<double>(last - first + 1) };
+            tieCorrection += tiedCount * tiedCount * tiedCount - tiedCount;
+            for (size_t index = first; index <= last; index++)
+            {
+                if (combined[index].second)
+                {
+                    currentRankSum += averageRank;
+                }
+            }
+            first = last + 1;
+        }
+
+        const double totalCount{ baselineCount + currentCount };
+        const double u{ currentRankSum - currentCount * (currentCount + 1.0) / 2.0 };
+        const double mean{ baselineCount * currentCount / 2.0 };
+        const double variance{ baselineCount * currentCount / 12.0 * ((totalCount + 1.0) - tieCorrection / (totalCount * (totalCount - 1.0))) };
+        if (variance <= 0.0)
+        {
+            return { u, 0.0, 1.0 };
+        }
+
+        const double z{ (u - mean - 0.5) / std::sqrt(variance) };
+        return { u, z, 0.5 * std::erfc(z / std::sqrt(2.0)) };
+    }
+
+    // Prints the comparison of every record found in the baseline, returns the number of regressions.
+    // A phase regressed if it's significantly slower and its median slowed down by at least the minimum slowdown.
+    [[nodiscard]] int32_t CompareToBaseline(std::ostream& outStream, const Baseline& baseline, const std::vector<BenchmarkRecord>& records, const RegressionOptions& options)
+    {
+        int32_t result{};
+        outStream << std::left << std::setw(8) << "Day" << std::setw(9) << "Version" << std::setw(16) << "Phase" << std::right
+            << std::setw(14) << "base median" << std::setw(14) << "median" << std::setw(9) << "ratio" << std::setw(12) << "p-value" << "  verdict\n";
+        for (const auto& record : records)
+        {
+            const auto baselineIterator{ baseline.find(GetBaselineKey(record)) };
+            if (baselineIterator == baseline.end())
+            {
+                continue;
+            }
+
+            const auto& baselineSamples{ baselineIterator->second };
+            const auto baselineMedian{ CalculateStatistics(baselineSamples).mMedian };
+            const auto currentMedian{ record.mStatistics.mMedian };
+            const double ratio{ baselineMedian.count() > 0 ? static_cast<double>(currentMedian.count()) / baselineMedian.count() : 1.0 };
+            const auto test{ MannWhitneyUTest(baselineSamples, record.mSamples) };
+            const bool isRegression{ test.mPValue < options.mSignificance && ratio >= options.mMinimumSlowdown };
+            if (isRegression)
+            {
+                ++result;
+            }
+
+            outStream << std::left << std::setw(8) << record.mDay << std::setw(9) << sInputVersionStringMap.at(record.mInputVersion)
+                << std::setw(16) << sPhaseStringMap.at(record.mPhase) << std::right
+                << std::setw(14) << baselineMedian.count() << std::setw(14) << currentMedian.count()
+                << std::setw(9) << std::fixed << std::setprecision(3) << ratio
+                << std::setw(12) << std::scientific << std::setprecision(2) << test.mPValue << std::defaultfloat
+                << "  " << (isRegression ? "REGRESSION" : "ok") << '\n';
+        }
+
+        return result;
+    }
+}
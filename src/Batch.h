@@ -0,0 +1,122 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+#include "Result.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace utility
+{
+    // A directory runs every regular file in it, in name order. Any other file is a manifest with one input path
+    // per line, relative paths are taken relative to the manifest. Empty lines and lines starting with # are skipped.
+    [[nodiscard]] std::expected<std::vector<std::filesystem::path>, std::string> CollectBatchInputs(const std::filesystem::path& path)
+    {
+        std::vector<std::filesystem::path> result;
+        std::error_code errorCode;
+        if (std::filesystem::is_directory(path, errorCode))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator{ path, errorCode })
+            {
+                if (entry.is_regular_file())
+                {
+                    result.push_back(entry.path());
+                }
+            }
+            if (errorCode)
+            {
+                return std::unexpected{ std::string{ "couldn't list batch directory " }.append(path.string()) };
+            }
+
+            std::ranges::sort(result);
+        }
+        else
+        {
+            std::ifstream inStream{ path };
+            if (!inStream)
+            {
+                return std::unexpected{ std::string{ "couldn't open batch manifest " }.append(path.string()) };
+            }
+
+            std::string line;
+            while (std::getline(inStream, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                if (line.empty() || line.front() == '#')
+                {
+                    continue;
+                }
+
+                const std::filesystem::path inputPath{ line };
+                result.push_back(inputPath.is_relative() ? path.parent_path() / inputPath : inputPath);
+            }
+        }
+
+        for (const auto& inputPath : result)
+        {
+            if (!std::filesystem::is_regular_file(inputPath, errorCode))
+            {
+                return std::unexpected{ std::string{ "batch input doesn't exist: " }.append(inputPath.string()) };
+            }
+        }
+
+        if (result.empty())
+        {
+            return std::unexpected{ std::string{ "no batch inputs in " }.append(path.string()) };
+        }
+
+        return result;
+    }
+
+    // One solved input, the latency covers reading the input and the requested parts.
+    struct BatchResult
+    {
+        PartResults mResults;
+        Duration mLatency{};
+        uintmax_t mInputSize{};
+    };
+
+    void PrintBatchReport(std::ostream& outStream, std::span<const std::filesystem::path> inputPaths, std::span<const BatchResult> results, Part part, Duration wallTime)
+    {
+        for (const auto& [inputPath, batchResult] : std::ranges::views::zip(inputPaths, results))
+        {
+            outStream << inputPath.string() << ':';
+            if (part != Part::second)
+            {
+                outStream << ' ' << ToString(batchResult.mResults.mFirst);
+            }
+            if (part != Part::first)
+            {
+                outStream << ' ' << ToString(batchResult.mResults.mSecond);
+            }
+            outStream << '\n';
+        }
+
+        std::vector<Duration> latencies;
+        uintmax_t totalSize{};
+        for (const auto& batchResult : results)
+        {
+            latencies.push_back(batchResult.mLatency);
+            totalSize += batchResult.mInputSize;
+        }
+
+        const double seconds{ std::chrono::duration<double>(wallTime).count() };
+        outStream << "[Batch]: " << results.size() << " input(s), " << totalSize << " bytes in " << wallTime.count() << " nanoseconds\n"
+            << std::fixed << std::setprecision(2)
+            << "[Batch]: " << results.size() / seconds << " inputs/s, " << totalSize / seconds / (1024.0 * 1024.0) << " MB/s\n"
+            << std::defaultfloat;
+        PrintStatisticsHeader(outStream);
+        PrintStatistics(outStream, "Latency", CalculateStatistics(std::move(latencies)));
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include "Utility.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utility
+{
+    using Duration = std::chrono::nanoseconds;
+    using BenchmarkClock = std::chrono::steady_clock;
+
+    static constexpr std::array<Phase, 3> sPhaseOrder{ Phase::readInput, Phase::first, Phase::second };
+
+    [[nodiscard]] constexpr size_t GetPhaseIndex(Phase phase)
+    {
+        return static_cast<size_t>(phase);
+    }
+
+    // The phases a run of the given part goes through, ReadInput is always part of it.
+    [[nodiscard]] std::vector<Phase> GetPhasesOfPart(Part part)
+    {
+        switch (part)
+        {
+        case Part::first:
+        {
+            return { Phase::readInput, Phase::first };
+        }
+        case Part::second:
+        {
+            return { Phase::readInput, Phase::second };
+        }
+        case Part::both:
+        {
+            return { Phase::readInput, Phase::first, Phase::second };
+        }
+        }
+
+        assert(false);
+        return {};
+    }
+
+    struct TimingStatistics
+    {
+        Duration mMinimum{};
+        Duration mMedian{};
+        Duration mP90{};
+        Duration mP99{};
+        Duration mMean{};
+        Duration mStandardDeviation{};
+        size_t mSampleCount{};
+    };
+
+    // Nearest-rank percentile, expects sorted samples.
+    [[nodiscard]] Duration GetPercentile(std::span<const Duration> sortedSamples, double percentile)
+    {
+        if (sortedSamples.empty())
+        {
+            return {};
+        }
+
+        const auto rank{ static_cast<size_t>(std::ceil(percentile / 100.0 * sortedSamples.size())) };
+        return sortedSamples[std::clamp<size_t>(rank, 1, sortedSamples.size()) - 1];
+    }
+
+    [[nodiscard]] TimingStatistics CalculateStatistics(std::vector<Duration> samples)
+    {
+        TimingStatistics result;
+        if (samples.empty())
+        {
+            return result;
+        }
+
+        std::ranges::sort(samples);
+        result.mSampleCount = samples.size();
+        result.mMinimum = samples.front();
+        result.mMedian = GetPercentile(samples, 50.0);
+        result.mP90 = GetPercentile(samples, 90.0);
+        result.mP99 = GetPercentile(samples, 99.0);
+
+        const double sum{ std::accumulate(samples.begin(), samples.end(), 0.0, [](double accumulator, Duration sample) {return accumulator + sample.count(); }) };
+        const double mean{ sum / samples.size() };
+        const double squaredDifferences{ std::accumulate(samples.begin(), samples.end(), 0.0, [mean](double accumulator, Duration sample)
+            {
+                const double difference{ sample.count() - mean };
+                return accumulator + difference * difference;
+            }) };
+        result.mMean = Duration{ static_cast<Duration::rep>(mean) };
+        result.mStandardDeviation = Duration{ static_cast<Duration::rep>(samples.size() > 1 ? std::sqrt(squaredDifferences / (samples.size() - 1)) : 0.0) };
+        return result;
+    }
+
+    // Samples of every phase, indexed by GetPhaseIndex.
+    using PhaseSamples = std::array<std::vector<Duration>, sPhaseOrder.size()>;
+
+    void PrintStatisticsHeader(std::ostream& outStream)
+    {
+        outStream << std::left << std::setw(16) << "Phase" << std::right
+            << std::setw(14) << "min" << std::setw(14) << "median" << std::setw(14) << "p90"
+            << std::setw(14) << "p99" << std::setw(14) << "mean" << std::setw(14) << "stddev" << "  (ns)\n";
+    }
+
+    void PrintStatistics(std::ostream& outStream, std::string_view label, const TimingStatistics& statistics)
+    {
+        outStream << std::left << std::setw(16) << label << std::right
+            << std::setw(14) << statistics.mMinimum.count() << std::setw(14) << statistics.mMedian.count()
+            << std::setw(14) << statistics.mP90.count() << std::setw(14) << statistics.mP99.count()
+            << std::setw(14) << statistics.mMean.count() << std::setw(14) << statistics.mStandardDeviation.count() << '\n';
+    }
+
+    void PrintStatistics(std::ostream& outStream, Phase phase, const TimingStatistics& statistics)
+    {
+        PrintStatistics(outStream, sPhaseStringMap.at(phase), statistics);
+    }
+}
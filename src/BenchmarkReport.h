@@ -0,0 +1,269 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "AllocationTracker.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef AOC24_GIT_REVISION
+#define AOC24_GIT_REVISION "unknown"
+#endif
+
+namespace utility
+{
+    enum class OutputFormat
+    {
+        text,
+        json,
+        csv,
+    };
+
+    static const std::unordered_map<std::string_view, OutputFormat> sOutputFormatArgumentMap
+    {
+        {"text", OutputFormat::text},
+        {"json", OutputFormat::json},
+        {"csv", OutputFormat::csv},
+    };
+
+    static constexpr std::string_view sGitRevision{ AOC24_GIT_REVISION };
+
+    // One measured phase of one day and input version.
+    struct BenchmarkRecord
+    {
+        std::string_view mDay;
+        InputVersion mInputVersion;
+        Phase mPhase;
+        TimingStatistics mStatistics;
+        std::optional<std::string> mResult;
+        uint32_t mThreadCount{ std::thread::hardware_concurrency() };
+        std::optional<uintmax_t> mInputSize;
+        std::vector<Duration> mSamples;
+        std::optional<CounterValues> mCounters;     // mean per iteration, only with --counters
+        std::optional<AllocationStatistics> mAllocations;   // only when built with AOC24_TRACK_ALLOCATIONS
+    };
+
+    // Everything a run produces besides its output, merged over all days that were run.
+    struct RunReport
+    {
+        std::vector<BenchmarkRecord> mRecords;
+        int32_t mCheckedAnswerCount{};
+        int32_t mWrongAnswerCount{};
+
+        void Append(RunReport&& other)
+        {
+            mRecords.insert(mRecords.end(), std::make_move_iterator(other.mRecords.begin()), std::make_move_iterator(other.mRecords.end()));
+            mCheckedAnswerCount += other.mCheckedAnswerCount;
+            mWrongAnswerCount += other.mWrongAnswerCount;
+        }
+    };
+
+    [[nodiscard]] std::string EscapeJsonString(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (const char character : text)
+        {
+            switch (character)
+            {
+            case '"':
+            {
+                result.append("\\\"");
+            }
+            break;
+            case '\\':
+            {
+                result.append("\\\\");
+            }
+            break;
+            case '\n':
+            {
+                result.append("\\n");
+            }
+            break;
+            default:
+            {
+                result.push_back(character);
+            }
+            break;
+            }
+        }
+
+        return result;
+    }
+
+    void WriteOptionalNumber(std::ostream& outStream, std::optional<double> value, std::string_view missing)
+    {
+        if (value)
+        {
+            outStream << std::fixed << std::setprecision(2) << *value << std::defaultfloat;
+        }
+        else
+        {
+            outStream << missing;
+        }
+    }
+
+    void WriteJsonCounters(std::ostream& outStream, const CounterValues& counters)
+    {
+        outStream << "{";
+        for (const auto counter : sHardwareCounterOrder)
+        {
+            outStream << '"' << sHardwareCounterStringMap.at(counter) << "\": ";
+            WriteOptionalNumber(outStream, counters.Get(counter), "null");
+            outStream << ", ";
+        }
+        outStream << "\"ipc\": ";
+        WriteOptionalNumber(outStream, counters.GetInstructionsPerCycle(), "null");
+        outStream << ", \"user_ns\": " << counters.mUserTime.count()
+            << ", \"system_ns\": " << counters.mSystemTime.count()
+            << ", \"voluntary_context_switches\": ";
+        WriteOptionalNumber(outStream, counters.mVoluntaryContextSwitches, "null");
+        outStream << ", \"involuntary_context_switches\": ";
+        WriteOptionalNumber(outStream, counters.mInvoluntaryContextSwitches, "null");
+        outStream << "}";
+    }
+
+    void WriteJson(std::ostream& outStream, const std::vector<BenchmarkRecord>& records)
+    {
+        outStream << "[\n";
+        for (const auto& [index, record] : records | std::ranges::views::enumerate)
+        {
+            const auto& statistics{ record.mStatistics };
+            outStream << "  {\"day\": \"" << EscapeJsonString(record.mDay) << '"'
+                << ", \"input_version\": \"" << sInputVersionStringMap.at(record.mInputVersion) << '"'
+                << ", \"phase\": \"" << sPhaseStringMap.at(record.mPhase) << '"'
+                << ", \"samples\": " << statistics.mSampleCount
+                << ", \"min_ns\": " << statistics.mMinimum.count()
+                << ", \"median_ns\": " << statistics.mMedian.count()
+                << ", \"p90_ns\": " << statistics.mP90.count()
+                << ", \"p99_ns\": " << statistics.mP99.count()
+                << ", \"mean_ns\": " << statistics.mMean.count()
+                << ", \"stddev_ns\": " << statistics.mStandardDeviation.count()
+                << ", \"result\": ";
+            if (record.mResult)
+            {
+                outStream << '"' << EscapeJsonString(*record.mResult) << '"';
+            }
+            else
+            {
+                outStream << "null";
+            }
+            outStream << ", \"threads\": " << record.mThreadCount
+                << ", \"input_bytes\": ";
+            if (record.mInputSize)
+            {
+                outStream << *record.mInputSize;
+            }
+            else
+            {
+                outStream << "null";
+            }
+            if (record.mCounters)
+            {
+                outStream << ", \"counters\": ";
+                WriteJsonCounters(outStream, *record.mCounters);
+            }
+            if (record.mAllocations)
+            {
+                outStream << std::fixed << std::setprecision(2)
+                    << ", \"allocations\": {\"count\": " << record.mAllocations->mAllocationCount
+                    << ", \"bytes\": " << record.mAllocations->mAllocatedBytes
+                    << ", \"peak_bytes\": " << record.mAllocations->mPeakLiveBytes << "}" << std::defaultfloat;
+            }
+            outStream << ", \"git_revision\": \"" << EscapeJsonString(sGitRevision) << "\"}"
+                << (index + 1 < static_cast<std::ptrdiff_t>(records.size()) ? ",\n" : "\n");
+        }
+        outStream << "]\n";
+    }
+
+    void WriteCsv(std::ostream& outStream, const std::vector<BenchmarkRecord>& records)
+    {
+        // the counter columns stay empty unless --counters was given
+        outStream << "day,input_version,phase,samples,min_ns,median_ns,p90_ns,p99_ns,mean_ns,stddev_ns,result,threads,input_bytes,git_revision";
+        for (const auto counter : sHardwareCounterOrder)
+        {
+            outStream << ',' << sHardwareCounterStringMap.at(counter);
+        }
+        outStream << ",ipc,user_ns,system_ns,voluntary_context_switches,involuntary_context_switches,allocations,allocated_bytes,peak_heap_bytes\n";
+        for (const auto& record : records)
+        {
+            const auto& statistics{ record.mStatistics };
+            outStream << record.mDay << ','
+                << sInputVersionStringMap.at(record.mInputVersion) << ','
+                << sPhaseStringMap.at(record.mPhase) << ','
+                << statistics.mSampleCount << ','
+                << statistics.mMinimum.count() << ','
+                << statistics.mMedian.count() << ','
+                << statistics.mP90.count() << ','
+                << statistics.mP99.count() << ','
+                << statistics.mMean.count() << ','
+                << statistics.mStandardDeviation.count() << ','
+                << record.mResult.value_or("") << ','
+                << record.mThreadCount << ',';
+            if (record.mInputSize)
+            {
+                outStream << *record.mInputSize;
+            }
+            outStream << ',' << sGitRevision;
+            for (const auto counter : sHardwareCounterOrder)
+            {
+                outStream << ',';
+                WriteOptionalNumber(outStream, record.mCounters ? record.mCounters->Get(counter) : std::nullopt, "");
+            }
+            outStream << ',';
+            WriteOptionalNumber(outStream, record.mCounters ? record.mCounters->GetInstructionsPerCycle() : std::nullopt, "");
+            outStream << ',';
+            if (record.mCounters)
+            {
+                outStream << record.mCounters->mUserTime.count();
+            }
+            outStream << ',';
+            if (record.mCounters)
+            {
+                outStream << record.mCounters->mSystemTime.count();
+            }
+            outStream << ',';
+            WriteOptionalNumber(outStream, record.mCounters ? record.mCounters->mVoluntaryContextSwitches : std::nullopt, "");
+            outStream << ',';
+            WriteOptionalNumber(outStream, record.mCounters ? record.mCounters->mInvoluntaryContextSwitches : std::nullopt, "");
+            outStream << ',';
+            WriteOptionalNumber(outStream, record.mAllocations ? std::optional{ record.mAllocations->mAllocationCount } : std::nullopt, "");
+            outStream << ',';
+            WriteOptionalNumber(outStream, record.mAllocations ? std::optional{ record.mAllocations->mAllocatedBytes } : std::nullopt, "");
+            outStream << ',';
+            if (record.mAllocations)
+            {
+                outStream << record.mAllocations->mPeakLiveBytes;
+            }
+            outStream << '\n';
+        }
+    }
+
+    void WriteRecords(std::ostream& outStream, OutputFormat format, const std::vector<BenchmarkRecord>& records)
+    {
+        switch (format)
+        {
+        case OutputFormat::json:
+        {
+            WriteJson(outStream, records);
+        }
+        break;
+        case OutputFormat::csv:
+        {
+            WriteCsv(outStream, records);
+        }
+        break;
+        case OutputFormat::text:
+        break;
+        }
+    }
+}
@@ -0,0 +1,279 @@
+#pragma once
+#include "Utility.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AOC24_BIT_GRID_SIMD
+#endif
+
+namespace utility
+{
+    namespace bits
+    {
+        using Word = uint64_t;
+        static constexpr int32_t sBitsPerWord{ 64 };
+
+#ifdef AOC24_BIT_GRID_SIMD
+        static constexpr size_t sWordsPerBlock{ 4 };
+
+        // Popcount of a 32 byte block per 64 bit lane, every nibble looked up in a 16 entry table.
+        [[nodiscard]] inline __m256i CountBlock(const Word* words)
+        {
+            const auto lookup{ _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4) };
+            const auto lowNibbleMask{ _mm256_set1_epi8(0x0F) };
+            const auto block{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)) };
+            const auto lowNibbles{ _mm256_and_si256(block, lowNibbleMask) };
+            const auto highNibbles{ _mm256_and_si256(_mm256_srli_epi16(block, 4), lowNibbleMask) };
+            const auto byteCounts{ _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lowNibbles), _mm256_shuffle_epi8(lookup, highNibbles)) };
+            return _mm256_sad_epu8(byteCounts, _mm256_setzero_si256());
+        }
+#endif
+
+        // Whole blocks are counted with AVX2 when it's enabled, the rest word by word, which is a popcnt with hardware support.
+        [[nodiscard]] inline size_t Count(std::span<const Word> words)
+        {
+            size_t index{ 0 };
+            size_t result{ 0 };
+#ifdef AOC24_BIT_GRID_SIMD
+            auto counts{ _mm256_setzero_si256() };
+            for (; index + sWordsPerBlock <= words.size(); index += sWordsPerBlock)
+            {
+                counts = _mm256_add_epi64(counts, CountBlock(words.data() + index));
+            }
+            alignas(32) std::array<uint64_t, sWordsPerBlock> lanes{};
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), counts);
+            result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+            for (; index < words.size(); index++)
+            {
+                result += static_cast<size_t>(std::popcount(words[index]));
+            }
+            return result;
+        }
+    }
+
+    // A two dimensional map of bits, row after row, every row starts on a word of its own.
+    // Column c of a row is bit c % 64 of word c / 64 of the row. The bits past the column count stay zero,
+    // so counting and the row operations don't have to mask them.
+    template<typename Allocator = std::allocator<bits::Word>>
+    class BitGrid
+    {
+    public:
+        using Word = bits::Word;
+        using PositionType = int32_t;
+        using Position = utility::Position<PositionType>;
+
+        BitGrid() = default;
+
+        explicit BitGrid(const Allocator& allocator) : mWords{ allocator } {}
+
+        BitGrid(PositionType rowCount, PositionType columnCount, const Allocator& allocator = {})
+            : mWords{ allocator }
+        {
+            Resize(rowCount, columnCount);
+        }
+
+        // Every bit is cleared, the allocation is kept when it's large enough.
+        void Resize(PositionType rowCount, PositionType columnCount)
+        {
+            assert(rowCount >= 0 && columnCount >= 0);
+            mRowCount = rowCount;
+            mColumnCount = columnCount;
+            mWordsPerRow = (static_cast<size_t>(columnCount) + bits::sBitsPerWord - 1) / bits::sBitsPerWord;
+            mWords.assign(static_cast<size_t>(rowCount) * mWordsPerRow, Word{ 0 });
+        }
+
+        [[nodiscard]] PositionType GetRowCount() const
+        {
+            return mRowCount;
+        }
+
+        [[nodiscard]] PositionType GetColumnCount() const
+        {
+            return mColumnCount;
+        }
+
+        [[nodiscard]] size_t GetWordsPerRow() const
+        {
+            return mWordsPerRow;
+        }
+
+        [[nodiscard]] bool IsInside(Position position) const
+        {
+            return position.mRow >= 0 && position.mRow < mRowCount && position.mCol >= 0 && position.mCol < mColumnCount;
+        }
+
+        [[nodiscard]] bool Test(Position position) const
+        {
+            return (GetWord(position) & GetMask(position.mCol)) != 0;
+        }
+
+        void Set(Position position)
+        {
+            GetWord(position) |= GetMask(position.mCol);
+        }
+
+        void Reset(Position position)
+        {
+            GetWord(position) &= ~GetMask(position.mCol);
+        }
+
+        // Sets the bit and returns whether it was set before, so a flood fill can check and mark a cell in one step.
+        bool TestAndSet(Position position)
+        {
+            auto& word{ GetWord(position) };
+            const auto mask{ GetMask(position.mCol) };
+            const bool wasSet{ (word & mask) != 0 };
+            word |= mask;
+            return wasSet;
+        }
+
+        // Same as TestAndSet, but safe against other threads setting bits of the same grid.
+        // Only the atomic operations may touch the grid while the threads run.
+        bool TestAndSetAtomic(Position position)
+        {
+            const auto mask{ GetMask(position.mCol) };
+            return (std::atomic_ref<Word>{ GetWord(position) }.fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+        }
+
+        [[nodiscard]] bool TestAtomic(Position position) const
+        {
+            return (std::atomic_ref<Word>{ const_cast<Word&>(GetWord(position)) }.load(std::memory_order_relaxed) & GetMask(position.mCol)) != 0;
+        }
+
+        void Clear()
+        {
+            if (!mWords.empty())
+            {
+                std::memset(mWords.data(), 0, mWords.size() * sizeof(Word));
+            }
+        }
+
+        [[nodiscard]] size_t Count() const
+        {
+            return bits::Count(mWords);
+        }
+
+        [[nodiscard]] size_t CountRow(PositionType row) const
+        {
+            return bits::Count(GetRow(row));
+        }
+
+        [[nodiscard]] std::span<Word> GetRow(PositionType row)
+        {
+            assert(row >= 0 && row < mRowCount);
+            return { mWords.data() + row * mWordsPerRow, mWordsPerRow };
+        }
+
+        [[nodiscard]] std::span<const Word> GetRow(PositionType row) const
+        {
+            assert(row >= 0 && row < mRowCount);
+            return { mWords.data() + row * mWordsPerRow, mWordsPerRow };
+        }
+
+        // The other row has to come from a grid of the same column count.
+        void AndRow(PositionType row, std::span<const Word> other)
+        {
+            assert(other.size() == mWordsPerRow);
+            std::ranges::transform(GetRow(row), other, GetRow(row).begin(), [](Word word, Word otherWord) { return word & otherWord; });
+        }
+
+        void OrRow(PositionType row, std::span<const Word> other)
+        {
+            assert(other.size() == mWordsPerRow);
+            std::ranges::transform(GetRow(row), other, GetRow(row).begin(), [](Word word, Word otherWord) { return word | otherWord; });
+        }
+
+        // Moves every bit of the row by columns, towards higher columns when positive. Bits moved out of the row are dropped.
+        void ShiftRow(PositionType row, PositionType columns)
+        {
+            auto words{ GetRow(row) };
+            const auto wordCount{ static_cast<ptrdiff_t>(words.size()) };
+            const auto wordShift{ static_cast<ptrdiff_t>(std::abs(columns) / bits::sBitsPerWord) };
+            const auto bitShift{ std::abs(columns) % bits::sBitsPerWord };
+            const auto getWord = [&](ptrdiff_t index) { return index >= 0 && index < wordCount ? words[index] : Word{ 0 }; };
+            if (columns > 0)
+            {
+                for (ptrdiff_t index = wordCount - 1; index >= 0; index--)
+                {
+                    const auto lower{ getWord(index - wordShift) };
+                    const auto carry{ bitShift != 0 ? getWord(index - wordShift - 1) >> (bits::sBitsPerWord - bitShift) : Word{ 0 } };
+                    words[index] = (lower << bitShift) | carry;
+                }
+                MaskLastWord(words);
+            }
+            else if (columns < 0)
+            {
+                for (ptrdiff_t index = 0; index < wordCount; index++)
+                {
+                    const auto higher{ getWord(index + wordShift) };
+                    const auto carry{ bitShift != 0 ? getWord(index + wordShift + 1) << (bits::sBitsPerWord - bitShift) : Word{ 0 } };
+                    words[index] = (higher >> bitShift) | carry;
+                }
+            }
+        }
+
+        // The whole grid at once, both grids have to be the same size.
+        void And(const BitGrid& other)
+        {
+            assert(other.mRowCount == mRowCount && other.mColumnCount == mColumnCount);
+            std::ranges::transform(mWords, other.mWords, mWords.begin(), [](Word word, Word otherWord) { return word & otherWord; });
+        }
+
+        void Or(const BitGrid& other)
+        {
+            assert(other.mRowCount == mRowCount && other.mColumnCount == mColumnCount);
+            std::ranges::transform(mWords, other.mWords, mWords.begin(), [](Word word, Word otherWord) { return word | otherWord; });
+        }
+
+    private:
+        [[nodiscard]] static Word GetMask(PositionType column)
+        {
+            return Word{ 1 } << (column % bits::sBitsPerWord);
+        }
+
+        [[nodiscard]] Word& GetWord(Position position)
+        {
+            assert(IsInside(position));
+            return mWords[position.mRow * mWordsPerRow + position.mCol / bits::sBitsPerWord];
+        }
+
+        [[nodiscard]] const Word& GetWord(Position position) const
+        {
+            assert(IsInside(position));
+            return mWords[position.mRow * mWordsPerRow + position.mCol / bits::sBitsPerWord];
+        }
+
+        void MaskLastWord(std::span<Word> words) const
+        {
+            if (const auto usedBits{ mColumnCount % bits::sBitsPerWord }; usedBits != 0 && !words.empty())
+            {
+                words.back() &= (Word{ 1 } << usedBits) - 1;
+            }
+        }
+
+        std::vector<Word, Allocator> mWords;
+        PositionType mRowCount{ 0 };
+        PositionType mColumnCount{ 0 };
+        size_t mWordsPerRow{ 0 };
+    };
+
+    namespace pmr
+    {
+        using BitGrid = utility::BitGrid<std::pmr::polymorphic_allocator<bits::Word>>;
+    }
+}
@@ -0,0 +1,538 @@
+#pragma once
+#include "Utility.h"
+#include "BenchmarkReport.h"
+#include "Baseline.h"
+#include "Scaling.h"
+#include "Result.h"
+#include "ParseCache.h"
+
+#include <charconv>
+#include <expected>
+#include <filesystem>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace utility
+{
+    struct BenchmarkOptions
+    {
+        bool mEnabled{ false };
+        int32_t mWarmupIterations{ 3 };
+        int32_t mRepetitions{ 10 };
+        bool mCounters{ false };
+    };
+
+    struct OutputOptions
+    {
+        OutputFormat mFormat{ OutputFormat::text };
+        std::filesystem::path mPath;
+    };
+
+    struct RunOptions
+    {
+        std::vector<int32_t> mDays;
+        bool mAllDays{ false };
+        bool mListDays{ false };
+        bool mShowHelp{ false };
+        Part mPart{ Part::both };
+        std::vector<InputVersion> mInputVersions{ InputVersion::test, InputVersion::release };
+        BenchmarkOptions mBenchmark;
+        OutputOptions mOutput;
+        RegressionOptions mRegression;
+        ScalingOptions mScaling;
+        InputSource mInputSource;
+        std::filesystem::path mExpectedAnswersPath;
+        ExpectedAnswers mExpectedAnswers;       // loaded from mExpectedAnswersPath after parsing
+        ParseCacheOptions mParseCache;
+        std::filesystem::path mBatchPath;
+        std::vector<std::filesystem::path> mBatchInputs;    // collected from mBatchPath after parsing
+        bool mPrefetch{ false };
+        bool mConcurrent{ false };
+        std::filesystem::path mTracePath;
+        bool mCompareStrategies{ false };
+    };
+
+    // Structured output written to stdout shouldn't be interleaved with the human readable report.
+    [[nodiscard]] std::ostream& GetLogStream(const RunOptions& options)
+    {
+        if (options.mOutput.mFormat != OutputFormat::text && options.mOutput.mPath.empty())
+        {
+            return std::cerr;
+        }
+
+        return std::cout;
+    }
+
+    static const std::unordered_map<std::string_view, Part> sPartArgumentMap
+    {
+        {"first", Part::first},
+        {"second", Part::second},
+        {"both", Part::both},
+    };
+
+    static const std::unordered_map<std::string_view, std::vector<InputVersion>> sInputVersionArgumentMap
+    {
+        {"test", {InputVersion::test}},
+        {"release", {InputVersion::release}},
+        {"synthetic", {InputVersion::synthetic}},
+        {"both", {InputVersion::test, InputVersion::release}},
+    };
+
+    void PrintUsage(std::ostream& outStream)
+    {
+        outStream << "Usage: AOC24 [--day <n>[,<n>...] | --all] [options]\n"
+            << "  --day <list>        Comma separated day numbers to run, e.g. --day 6,11,16\n"
+            << "  --all               Run every registered day\n"
+            << "  --part <part>       first | second | both (default: both)\n"
+            << "  --input <version>   test | release | synthetic | both (default: both)\n"
+            << "  --input-file <path> Read the input from a file instead of the input directory, - reads stdin\n"
+            << "  --stream            Parse line oriented days chunk by chunk instead of holding the whole input\n"
+            << "  --chunk-size <n>    Bytes per chunk when streaming (default: 1048576)\n"
+            << "  --synthetic-size <n>  Approximate element count of generated inputs (default: 1000)\n"
+            << "  --seed <n>          Seed of generated inputs (default: 1)\n"
+            << "  --benchmark         Time ReadInput, PerformFirst and PerformSecond separately over repeated runs\n"
+            << "  --warmup <n>        Unmeasured iterations before benchmarking (default: 3)\n"
+            << "  --repetitions <n>   Measured iterations when benchmarking (default: 10)\n"
+            << "  --counters          Report hardware counters, CPU time and context switches per phase, implies --benchmark\n"
+            << "  --format <format>   text | json | csv, json and csv imply --benchmark (default: text)\n"
+            << "  --output <path>     File to write json or csv records to (default: stdout)\n"
+            << "  --save-baseline <path>     Store the timing samples as a baseline, implies --benchmark\n"
+            << "  --compare-baseline <path>  Compare against a baseline and exit with 2 on a regression, implies --benchmark\n"
+            << "  --significance <alpha>     Mann-Whitney U significance level of a regression (default: 0.01)\n"
+            << "  --min-slowdown <ratio>     Median slowdown a regression has to reach (default: 1.05)\n"
+            << "  --scaling           Run the parts on synthetic inputs of growing size and fit their complexity\n"
+            << "  --scaling-start <n>    Smallest synthetic size of --scaling (default: 250)\n"
+            << "  --scaling-steps <n>    Number of sizes of --scaling (default: 5)\n"
+            << "  --scaling-factor <f>   Growth factor between the sizes of --scaling (default: 2)\n"
+            << "  --superlinear-exponent <e>  Fitted exponent above which a phase is flagged (default: 1.2)\n"
+            << "  --parse-cache       Store parsed inputs in a binary cache keyed by the input content and load them on later runs\n"
+            << "  --parse-cache-dir <path>  Directory of the parse cache, implies --parse-cache (default: .parse_cache in the input directory)\n"
+            << "  --prefetch          Read the input of the next day on the thread pool while the current one is solved\n"
+            << "  --concurrent        Run the days and their parts as a task graph on the thread pool, the output keeps its order\n"
+            << "  --trace <path>      Write the trace zones of the run as Chrome trace JSON, for chrome://tracing or Perfetto\n"
+            << "  --strategies        Time every implementation a day has of a part on the same input and compare their answers\n"
+            << "  --batch <path>      Solve every input of a directory or manifest concurrently and report the throughput, needs a single day\n"
+            << "  --expected <path>   Answers to check the results against (default: expected_answers.txt in the input directory)\n"
+            << "  --list              List the registered days\n"
+            << "  --help              Show this message\n";
+    }
+
+    [[nodiscard]] std::expected<std::vector<int32_t>, std::string> ParseDayList(std::string_view argument)
+    {
+        using namespace std::literals;
+        std::vector<int32_t> result;
+        for (const auto dayString : argument | std::ranges::views::split(","sv)
+            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+        {
+            const auto day{ TryToNumber<int32_t>(dayString) };
+            if (!day || dayString.front() == '-')
+            {
+                return std::unexpected{ std::string{ "invalid day: '" }.append(dayString).append("'") };
+            }
+
+            result.push_back(*day);
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] std::expected<int32_t, std::string> ParseCount(std::string_view argument, int32_t minimum)
+    {
+        const auto result{ TryToNumber<int32_t>(argument) };
+        if (!result || argument.front() == '-')
+        {
+            return std::unexpected{ std::string{ "invalid count: '" }.append(argument).append("'") };
+        }
+
+        if (*result < minimum)
+        {
+            return std::unexpected{ std::string{ "count has to be at least " }.append(std::to_string(minimum)) };
+        }
+
+        return *result;
+    }
+
+    [[nodiscard]] std::expected<double, std::string> ParsePositiveDouble(std::string_view argument)
+    {
+        double result{};
+        if (const auto [end, errorCode] {std::from_chars(argument.data(), argument.data() + argument.size(), result)};
+            errorCode != std::errc{} || end != argument.data() + argument.size() || result <= 0.0)
+        {
+            return std::unexpected{ std::string{ "invalid value: '" }.append(argument).append("'") };
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] std::expected<RunOptions, std::string> ParseCommandLine(int argc, char* argv[])
+    {
+        RunOptions result;
+        bool isInputVersionGiven{ false };
+        const std::vector<std::string_view> arguments(argv + 1, argv + argc);
+        for (auto argumentIterator{ arguments.begin() }; argumentIterator != arguments.end(); ++argumentIterator)
+        {
+            const std::string_view argument{ *argumentIterator };
+            const auto getValue = [&]() -> std::expected<std::string_view, std::string>
+                {
+                    if (std::next(argumentIterator) == arguments.end())
+                    {
+                        return std::unexpected{ std::string{ "missing value for " }.append(argument) };
+                    }
+
+                    return *++argumentIterator;
+                };
+
+            if (argument == "--all")
+            {
+                result.mAllDays = true;
+            }
+            else if (argument == "--list")
+            {
+                result.mListDays = true;
+            }
+            else if (argument == "--help" || argument == "-h")
+            {
+                result.mShowHelp = true;
+            }
+            else if (argument == "--benchmark")
+            {
+                result.mBenchmark.mEnabled = true;
+            }
+            else if (argument == "--counters")
+            {
+                result.mBenchmark.mCounters = true;
+            }
+            else if (argument == "--warmup" || argument == "--repetitions")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto count{ ParseCount(*value, argument == "--warmup" ? 0 : 1) };
+                if (!count.has_value())
+                {
+                    return std::unexpected{ count.error() };
+                }
+
+                (argument == "--warmup" ? result.mBenchmark.mWarmupIterations : result.mBenchmark.mRepetitions) = *count;
+            }
+            else if (argument == "--format")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto formatIterator{ sOutputFormatArgumentMap.find(*value) };
+                if (formatIterator == sOutputFormatArgumentMap.end())
+                {
+                    return std::unexpected{ std::string{ "invalid format: '" }.append(*value).append("'") };
+                }
+
+                result.mOutput.mFormat = formatIterator->second;
+            }
+            else if (argument == "--output")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mOutput.mPath = *value;
+            }
+            else if (argument == "--save-baseline" || argument == "--compare-baseline")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                (argument == "--save-baseline" ? result.mRegression.mSaveBaselinePath : result.mRegression.mCompareBaselinePath) = *value;
+            }
+            else if (argument == "--significance" || argument == "--min-slowdown")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto number{ ParsePositiveDouble(*value) };
+                if (!number.has_value())
+                {
+                    return std::unexpected{ number.error() };
+                }
+
+                (argument == "--significance" ? result.mRegression.mSignificance : result.mRegression.mMinimumSlowdown) = *number;
+            }
+            else if (argument == "--synthetic-size" || argument == "--seed")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto count{ ParseCount(*value, argument == "--synthetic-size" ? 1 : 0) };
+                if (!count.has_value())
+                {
+                    return std::unexpected{ count.error() };
+                }
+
+                auto& settings{ GetSyntheticInputSettings() };
+                if (argument == "--synthetic-size")
+                {
+                    settings.mSize = static_cast<size_t>(*count);
+                }
+                else
+                {
+                    settings.mSeed = static_cast<uint64_t>(*count);
+                }
+            }
+            else if (argument == "--scaling")
+            {
+                result.mScaling.mEnabled = true;
+            }
+            else if (argument == "--scaling-start" || argument == "--scaling-steps")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto count{ ParseCount(*value, argument == "--scaling-start" ? 1 : 2) };
+                if (!count.has_value())
+                {
+                    return std::unexpected{ count.error() };
+                }
+
+                (argument == "--scaling-start" ? result.mScaling.mMinimumSize : result.mScaling.mSteps) = *count;
+            }
+            else if (argument == "--scaling-factor" || argument == "--superlinear-exponent")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto number{ ParsePositiveDouble(*value) };
+                if (!number.has_value())
+                {
+                    return std::unexpected{ number.error() };
+                }
+
+                if (argument == "--scaling-factor" && *number <= 1.0)
+                {
+                    return std::unexpected{ std::string{ "scaling factor has to be greater than 1" } };
+                }
+
+                (argument == "--scaling-factor" ? result.mScaling.mFactor : result.mScaling.mSuperlinearExponent) = *number;
+            }
+            else if (argument == "--day")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                auto days{ ParseDayList(*value) };
+                if (!days.has_value())
+                {
+                    return std::unexpected{ days.error() };
+                }
+
+                result.mDays.insert(result.mDays.end(), days->begin(), days->end());
+            }
+            else if (argument == "--part")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto partIterator{ sPartArgumentMap.find(*value) };
+                if (partIterator == sPartArgumentMap.end())
+                {
+                    return std::unexpected{ std::string{ "invalid part: '" }.append(*value).append("'") };
+                }
+
+                result.mPart = partIterator->second;
+            }
+            else if (argument == "--input")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto inputVersionIterator{ sInputVersionArgumentMap.find(*value) };
+                if (inputVersionIterator == sInputVersionArgumentMap.end())
+                {
+                    return std::unexpected{ std::string{ "invalid input version: '" }.append(*value).append("'") };
+                }
+
+                result.mInputVersions = inputVersionIterator->second;
+                isInputVersionGiven = true;
+            }
+            else if (argument == "--input-file")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mInputSource.mIsStandardInput = *value == "-";
+                result.mInputSource.mPath = result.mInputSource.mIsStandardInput ? std::filesystem::path{} : std::filesystem::path{ *value };
+            }
+            else if (argument == "--parse-cache")
+            {
+                result.mParseCache.mEnabled = true;
+            }
+            else if (argument == "--parse-cache-dir")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mParseCache.mEnabled = true;
+                result.mParseCache.mDirectory = *value;
+            }
+            else if (argument == "--prefetch")
+            {
+                result.mPrefetch = true;
+            }
+            else if (argument == "--strategies")
+            {
+                result.mCompareStrategies = true;
+            }
+            else if (argument == "--concurrent")
+            {
+                result.mConcurrent = true;
+            }
+            else if (argument == "--batch")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mBatchPath = *value;
+            }
+            else if (argument == "--trace")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mTracePath = *value;
+            }
+            else if (argument == "--expected")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                result.mExpectedAnswersPath = *value;
+            }
+            else if (argument == "--stream")
+            {
+                result.mInputSource.mIsStreaming = true;
+            }
+            else if (argument == "--chunk-size")
+            {
+                const auto value{ getValue() };
+                if (!value.has_value())
+                {
+                    return std::unexpected{ value.error() };
+                }
+
+                const auto count{ ParseCount(*value, 1) };
+                if (!count.has_value())
+                {
+                    return std::unexpected{ count.error() };
+                }
+
+                result.mInputSource.mChunkSize = static_cast<size_t>(*count);
+            }
+            else
+            {
+                return std::unexpected{ std::string{ "unknown argument: '" }.append(argument).append("'") };
+            }
+        }
+
+        if (result.mOutput.mFormat != OutputFormat::text || result.mBenchmark.mCounters
+            || !result.mRegression.mSaveBaselinePath.empty() || !result.mRegression.mCompareBaselinePath.empty())
+        {
+            result.mBenchmark.mEnabled = true;
+        }
+
+        // a given input file replaces the file of every input version, running it once is enough by default
+        if ((result.mInputSource.IsOverridden() || !result.mBatchPath.empty()) && !isInputVersionGiven)
+        {
+            result.mInputVersions = { InputVersion::release };
+        }
+
+        if (result.mInputSource.mIsStandardInput)
+        {
+            const bool isSingleDay{ !result.mAllDays && result.mDays.size() == 1 };
+            if (result.mBenchmark.mEnabled || result.mScaling.mEnabled || result.mInputVersions.size() > 1 || !isSingleDay)
+            {
+                return std::unexpected{ std::string{ "standard input can only be read once, it needs a single day and input version without benchmarking" } };
+            }
+        }
+
+        if (result.mParseCache.mEnabled && result.mParseCache.mDirectory.empty())
+        {
+            result.mParseCache.mDirectory = std::filesystem::path{ INPUT_DIR } / ".parse_cache";
+        }
+
+        if (!result.mBatchPath.empty())
+        {
+            const bool isSingleDay{ !result.mAllDays && result.mDays.size() == 1 };
+            if (!isSingleDay || result.mInputVersions.size() > 1 || result.mInputSource.IsOverridden() || result.mBenchmark.mEnabled || result.mScaling.mEnabled)
+            {
+                return std::unexpected{ std::string{ "--batch needs a single day and input version, without an input file, benchmarking or scaling" } };
+            }
+        }
+
+        // benchmarks read the input as a measured phase, batches and scaling set up their own days
+        if (result.mPrefetch && (result.mBenchmark.mEnabled || result.mScaling.mEnabled || !result.mBatchPath.empty()))
+        {
+            return std::unexpected{ std::string{ "--prefetch only applies to plain runs, not to benchmarking, scaling or batches" } };
+        }
+
+        if (result.mCompareStrategies && (result.mBenchmark.mEnabled || result.mScaling.mEnabled || !result.mBatchPath.empty() || result.mPrefetch || result.mConcurrent))
+        {
+            return std::unexpected{ std::string{ "--strategies times the parts itself, it's not combined with benchmarking, scaling, batches, --prefetch or --concurrent" } };
+        }
+
+        if (result.mConcurrent && (result.mPrefetch || result.mBenchmark.mEnabled || result.mScaling.mEnabled || !result.mBatchPath.empty()))
+        {
+            return std::unexpected{ std::string{ "--concurrent only applies to plain runs, it reads every input ahead anyway, so it's not combined with --prefetch" } };
+        }
+
+        return result;
+    }
+}
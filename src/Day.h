@@ -1,70 +1,762 @@
 #pragma once
 #include "Utility.h"
+#include "CommandLine.h"
+#include "Benchmark.h"
+#include "PerfCounters.h"
+#include "AllocationTracker.h"
+#include "BenchmarkReport.h"
+#include "Scaling.h"
+#include "Result.h"
+#include "ScratchArena.h"
+#include "Batch.h"
+#include "ParseCache.h"
+#include "Future.h"
+#include "TaskGraph.h"
+#include "Trace.h"
+#include "Strategy.h"
+#include "ThreadPool.h"
+#include <array>
 #include <chrono>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <vector>
 
 static constexpr std::string_view sFirstPartResultString{ "First Part Result : " };
 static constexpr std::string_view sSecondPartResultString{ "Second Part Result : " };
 
 class AbstractDay
 {
-    virtual void Perform(utility::Part part) = 0;
+    virtual utility::PartResults Perform(utility::Part part) = 0;
 
 protected:
     virtual void ReadInput() = 0;
-    virtual void PerformFirst() = 0;
-    virtual void PerformSecond() = 0;
+    // The parts only read the members ReadInput set up, so both may run at the same time on one instance.
+    // What they need to change goes in their scratch arena or in locals.
+    virtual utility::Result PerformFirst() = 0;
+    virtual utility::Result PerformSecond() = 0;
 };
 
 template<utility::InputVersion version = utility::InputVersion::release>
 class DayBase : public AbstractDay
 {
 public:
-    void Perform(utility::Part part) override
+    utility::PartResults Perform(utility::Part part) override
     {
-        ReadInput();
+        utility::PartResults result;
+        AwaitInput();
         switch (part)
         {
         case utility::Part::first:
         {
-            PerformFirst();
+            result.mFirst = PerformPhase(utility::Phase::first);
         }
         break;
         case utility::Part::second:
         {
-            PerformSecond();
+            result.mSecond = PerformPhase(utility::Phase::second);
         }
         break;
         case utility::Part::both:
         {
-            PerformFirst();
-            PerformSecond();
+            result.mFirst = PerformPhase(utility::Phase::first);
+            result.mSecond = PerformPhase(utility::Phase::second);
+        }
+        break;
+        }
+
+        return result;
+    }
+
+    void SetInputSource(utility::InputSource source)
+    {
+        mInputSource = std::move(source);
+    }
+
+    void SetParseCache(utility::ParseCache parseCache)
+    {
+        mParseCache.emplace(std::move(parseCache));
+    }
+
+    // Runs one of the strategies the day lists for the part of the phase, the input has to be read already.
+    template<typename Day>
+        requires std::derived_from<Day, DayBase>
+    utility::Result PerformStrategy(utility::Phase phase, utility::Result(Day::* perform)())
+    {
+        return PerformPart(phase, [this, perform] { return (static_cast<Day*>(this)->*perform)(); });
+    }
+
+    // Starts reading the input on the thread pool, reading it later waits for that instead.
+    // Once started, the read has to be waited for before the day is destroyed, it works on the members of the derived day,
+    // which are gone by the time the future in this base would wait. See WaitForPrefetch.
+    void PrefetchInput()
+    {
+        mInputFuture = ReadInputOnPool();
+    }
+
+    // Waits for a prefetch that's still reading, an exception it threw is dropped. For days that go without being performed.
+    void WaitForPrefetch()
+    {
+        mInputFuture = {};
+    }
+
+    // Reading the input has no result. Once the input is read, both parts may run at the same time, see AbstractDay.
+    utility::Result PerformPhase(utility::Phase phase)
+    {
+        switch (phase)
+        {
+        case utility::Phase::readInput:
+        {
+            AwaitInput();
         }
         break;
+        case utility::Phase::first:
+        {
+            return PerformPart(utility::Phase::first, [this] { return PerformFirst(); });
         }
+        case utility::Phase::second:
+        {
+            return PerformPart(utility::Phase::second, [this] { return PerformSecond(); });
+        }
+        }
+
+        return {};
+    }
+
+protected:
+    [[nodiscard]] const utility::InputSource& GetInputSource() const
+    {
+        return mInputSource;
+    }
+
+    // For scratch containers of the running part, it's released as a whole once the part is done.
+    // Anything outliving the part, like members set up in ReadInput, has to stay on the default heap.
+    [[nodiscard]] std::pmr::memory_resource* GetScratchResource()
+    {
+        assert(sCurrentScratchArena);
+        return sCurrentScratchArena->GetResource();
+    }
+
+    // Days supporting the parse cache write what ReadInput parsed and read it back in the same order,
+    // with one BinaryReader::ReadAll, so the members stay untouched unless the whole payload is read.
+    // They also define a static constexpr uint32_t sParseCacheVersion, bumped whenever the written members change.
+    virtual bool WriteParsedInput(utility::BinaryWriter&) const
+    {
+        return false;
+    }
+
+    virtual bool ReadParsedInput(utility::BinaryReader&)
+    {
+        return false;
+    }
+
+private:
+    // The arena is found through the thread running the part, a thread waiting in one part may run the other one meanwhile.
+    template<typename Function>
+    utility::Result PerformPart(utility::Phase phase, Function&& perform)
+    {
+        utility::ScopedZone zone{ utility::sPhaseStringMap.at(phase), "phase" };
+        auto& scratchArena{ mScratchArenas[phase == utility::Phase::first ? 0 : 1] };
+        auto* const previousScratchArena{ std::exchange(sCurrentScratchArena, &scratchArena) };
+        auto result{ perform() };
+        sCurrentScratchArena = previousScratchArena;
+        scratchArena.Release();
+        return result;
     }
+
+    utility::Future<> ReadInputOnPool()
+    {
+        co_await utility::ResumeOnPool{};
+        ReadInputThroughParseCache();
+    }
+
+    void AwaitInput()
+    {
+        if (mInputFuture.IsValid())
+        {
+            std::exchange(mInputFuture, {}).Get();
+            return;
+        }
+
+        ReadInputThroughParseCache();
+    }
+
+    void ReadInputThroughParseCache()
+    {
+        utility::ScopedZone zone{ utility::sPhaseStringMap.at(utility::Phase::readInput), "phase" };
+        if (!mParseCache)
+        {
+            ReadInput();
+            return;
+        }
+
+        // ReadParsedInput leaves the members alone unless it reads all of the payload, ReadInput starts from nothing then
+        if (const auto payload{ mParseCache->Load() })
+        {
+            utility::BinaryReader reader{ *payload };
+            if (ReadParsedInput(reader))
+            {
+                return;
+            }
+        }
+
+        ReadInput();
+        utility::BinaryWriter writer;
+        if (WriteParsedInput(writer))
+        {
+            mParseCache->Store(writer.GetView());
+        }
+    }
+
+    utility::InputSource mInputSource;
+    std::array<utility::ScratchArena, 2> mScratchArenas;
+    static inline thread_local utility::ScratchArena* sCurrentScratchArena{ nullptr };
+    std::optional<utility::ParseCache> mParseCache;
+    utility::Future<> mInputFuture;
 };
 
 template<template<utility::InputVersion version = utility::InputVersion::release> class Day>
 class DayWrapper
 {
 public:
-    void Perform()
+    // Returns the benchmark records of the run, there are none unless benchmarking, and the answer checks.
+    utility::RunReport Perform(const utility::RunOptions& options)
+    {
+        utility::RunReport result;
+        utility::GetLogStream(options) << Day<>::sDay << '\n';
+        if (options.mScaling.mEnabled)
+        {
+            result.mRecords = Scale(options);
+            return result;
+        }
+
+        for (const auto inputVersion : options.mInputVersions)
+        {
+            switch (inputVersion)
+            {
+            case utility::InputVersion::test:
+            {
+                result.Append(options.mBatchInputs.empty() ? Perform<utility::InputVersion::test>(options) : Batch<utility::InputVersion::test>(options));
+            }
+            break;
+            case utility::InputVersion::release:
+            {
+                result.Append(options.mBatchInputs.empty() ? Perform<utility::InputVersion::release>(options) : Batch<utility::InputVersion::release>(options));
+            }
+            break;
+            case utility::InputVersion::synthetic:
+            {
+                result.Append(options.mBatchInputs.empty() ? Perform<utility::InputVersion::synthetic>(options) : Batch<utility::InputVersion::synthetic>(options));
+            }
+            break;
+            }
+        }
+
+        return result;
+    };
+
+    // Sets up the days of a plain run and starts reading their inputs on the thread pool, Perform picks them up.
+    void Prefetch(const utility::RunOptions& options)
+    {
+        for (const auto inputVersion : options.mInputVersions)
+        {
+            switch (inputVersion)
+            {
+            case utility::InputVersion::test:
+            {
+                Prefetch<utility::InputVersion::test>(options);
+            }
+            break;
+            case utility::InputVersion::release:
+            {
+                Prefetch<utility::InputVersion::release>(options);
+            }
+            break;
+            case utility::InputVersion::synthetic:
+            {
+                Prefetch<utility::InputVersion::synthetic>(options);
+            }
+            break;
+            }
+        }
+    }
+
+    // Adds the plain run of every input version to the graph. Reading the input comes first, then both parts run at the same time,
+    // then the results are printed. Printing waits for the previous print, so the output keeps the order of a sequential run.
+    // The nodes don't refer to the wrapper, it can go before the graph runs. Returns the last print node.
+    utility::TaskGraph::NodeId Schedule(utility::TaskGraph& taskGraph, const utility::RunOptions& options,
+        std::optional<utility::TaskGraph::NodeId> previousReport, utility::RunReport& report)
+    {
+        std::vector<utility::TaskGraph::NodeId> dependencies;
+        if (previousReport)
+        {
+            dependencies.push_back(*previousReport);
+        }
+
+        auto result{ taskGraph.AddNode([&options] { utility::GetLogStream(options) << Day<>::sDay << '\n'; }, dependencies) };
+        for (const auto inputVersion : options.mInputVersions)
+        {
+            switch (inputVersion)
+            {
+            case utility::InputVersion::test:
+            {
+                result = Schedule<utility::InputVersion::test>(taskGraph, options, result, report);
+            }
+            break;
+            case utility::InputVersion::release:
+            {
+                result = Schedule<utility::InputVersion::release>(taskGraph, options, result, report);
+            }
+            break;
+            case utility::InputVersion::synthetic:
+            {
+                result = Schedule<utility::InputVersion::synthetic>(taskGraph, options, result, report);
+            }
+            break;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    // A prefetched day may be destroyed while its input is still read, e.g. when the run before it throws.
+    struct PrefetchedDayDeleter
+    {
+        template<utility::InputVersion version>
+        void operator()(Day<version>* day) const
+        {
+            day->WaitForPrefetch();
+            delete day;
+        }
+    };
+
+    template<utility::InputVersion version>
+    using PrefetchedDay = std::unique_ptr<Day<version>, PrefetchedDayDeleter>;
+
+    // Shared by the nodes of one input version, the day goes once its results are printed.
+    template<utility::InputVersion version>
+    struct ScheduledRun
+    {
+        std::unique_ptr<Day<version>> mDay;
+        utility::PartResults mResults;
+        std::array<std::chrono::nanoseconds, utility::sPhaseOrder.size()> mDurations{};
+    };
+
+    // The time printed is the sum of the phases, the parts may have overlapped.
+    template<utility::InputVersion version>
+    static utility::TaskGraph::NodeId Schedule(utility::TaskGraph& taskGraph, const utility::RunOptions& options,
+        utility::TaskGraph::NodeId previousReport, utility::RunReport& report)
+    {
+        auto run{ std::make_shared<ScheduledRun<version>>() };
+        run->mDay = std::make_unique<Day<version>>();
+        PrepareDay(*run->mDay, options, options.mInputSource);
+
+        const auto performPhase = [&run](utility::Phase phase)
+            {
+                return [run, phase]
+                    {
+                        utility::ScopedZone zone{ Day<>::sDay, utility::sInputVersionStringMap.at(version) };
+                        const auto start{ std::chrono::high_resolution_clock::now() };
+                        auto phaseResult{ run->mDay->PerformPhase(phase) };
+                        run->mDurations[utility::GetPhaseIndex(phase)] = std::chrono::high_resolution_clock::now() - start;
+                        if (phase == utility::Phase::first)
+                        {
+                            run->mResults.mFirst = std::move(phaseResult);
+                        }
+                        else if (phase == utility::Phase::second)
+                        {
+                            run->mResults.mSecond = std::move(phaseResult);
+                        }
+                    };
+            };
+
+        const auto readInput{ taskGraph.AddNode(performPhase(utility::Phase::readInput)) };
+        std::vector<utility::TaskGraph::NodeId> reportDependencies{ previousReport };
+        for (const auto phase : utility::GetPhasesOfPart(options.mPart))
+        {
+            if (phase != utility::Phase::readInput)
+            {
+                reportDependencies.push_back(taskGraph.AddNode(performPhase(phase), { readInput }));
+            }
+        }
+
+        return taskGraph.AddNode([run, &options, &report]
+            {
+                run->mDay.reset();
+                const std::chrono::nanoseconds duration{ std::accumulate(run->mDurations.begin(), run->mDurations.end(), std::chrono::nanoseconds{}) };
+                report.Append(Report<version>(options, run->mResults, duration));
+            }, reportDependencies);
+    }
+
+    template<utility::InputVersion version>
+    void Prefetch(const utility::RunOptions& options)
+    {
+        auto& day{ std::get<PrefetchedDay<version>>(mPrefetchedDays) };
+        day.reset(new Day<version>{});
+        PrepareDay(*day, options, options.mInputSource);
+        day->PrefetchInput();
+    }
+
+    // With a prefetched day the time covers only what's left of reading the input.
+    template<utility::InputVersion version>
+    utility::RunReport Perform(const utility::RunOptions& options)
+    {
+        if (options.mBenchmark.mEnabled)
+        {
+            return Benchmark<version>(options);
+        }
+
+        if (options.mCompareStrategies)
+        {
+            return CompareStrategies<version>(options);
+        }
+
+        auto day{ std::exchange(std::get<PrefetchedDay<version>>(mPrefetchedDays), nullptr) };
+        if (!day)
+        {
+            day.reset(new Day<version>{});
+            PrepareDay(*day, options, options.mInputSource);
+        }
+        utility::PartResults results;
+        const auto start{ std::chrono::high_resolution_clock::now() };
+        {
+            utility::ScopedZone zone{ Day<>::sDay, utility::sInputVersionStringMap.at(version) };
+            results = day->Perform(options.mPart);
+        }
+        const auto end{ std::chrono::high_resolution_clock::now() };
+        return Report<version>(options, results, end - start);
+    }
+
+    // printed after the measurement, so formatting isn't part of the timing
+    template<utility::InputVersion version>
+    static utility::RunReport Report(const utility::RunOptions& options, const utility::PartResults& results, std::chrono::nanoseconds duration)
+    {
+        utility::RunReport result;
+        for (const auto& [part, partResult] : { std::pair{ utility::Part::first, &results.mFirst }, std::pair{ utility::Part::second, &results.mSecond } })
+        {
+            if (options.mPart != utility::Part::both && options.mPart != part)
+            {
+                continue;
+            }
+
+            utility::PrintDetails(version, part);
+            utility::PrintResult(utility::ToString(*partResult));
+            CheckAnswer<version>(options, std::cout, part, *partResult, result);
+        }
+        std::cout << utility::sInputVersionStringMap.at(version) << " took: " << duration.count() << " nanoseconds\n";
+        return result;
+    }
+
+    // Every input runs on its own instance as a task on the thread pool. Days that use the pool themselves
+    // help out with other inputs while they wait, which then counts towards their latency.
+    // The answers are printed in input order once everything is done, there's no expected answer to check them against.
+    template<utility::InputVersion version>
+    utility::RunReport Batch(const utility::RunOptions& options)
+    {
+        const auto& inputPaths{ options.mBatchInputs };
+        std::vector<utility::BatchResult> results(inputPaths.size());
+
+        const auto start{ utility::BenchmarkClock::now() };
+        utility::ParallelFor(0, inputPaths.size(), [&options, &inputPaths, &results](size_t index)
+            {
+                auto inputSource{ options.mInputSource };
+                inputSource.mPath = inputPaths[index];
+
+                auto& batchResult{ results[index] };
+                batchResult.mInputSize = utility::InputReader<Day<version>, version>{ inputSource }.GetSize().value_or(0);
+
+                utility::ScopedZone zone{ Day<>::sDay, "batch" };
+                const auto inputStart{ utility::BenchmarkClock::now() };
+                Day<version> day;
+                PrepareDay(day, options, std::move(inputSource));
+                batchResult.mResults = day.Perform(options.mPart);
+                batchResult.mLatency = std::chrono::duration_cast<utility::Duration>(utility::BenchmarkClock::now() - inputStart);
+            }, 1);
+        const auto wallTime{ std::chrono::duration_cast<utility::Duration>(utility::BenchmarkClock::now() - start) };
+
+        utility::PrintBatchReport(utility::GetLogStream(options), inputPaths, results, options.mPart, wallTime);
+        return {};
+    }
+
+    // Standard input can't be hashed ahead of parsing and streaming is meant to never hold the whole input,
+    // the parse cache is left out for both.
+    template<utility::InputVersion version>
+    static void PrepareDay(Day<version>& day, const utility::RunOptions& options, utility::InputSource inputSource)
+    {
+        if constexpr (requires { Day<version>::sParseCacheVersion; })
+        {
+            if (options.mParseCache.mEnabled && !inputSource.mIsStandardInput && !inputSource.mIsStreaming)
+            {
+                day.SetParseCache(utility::ParseCache{ options.mParseCache.mDirectory, Day<version>::sDay, version,
+                    utility::InputReader<Day<version>, version>{ inputSource }.GetPath(), Day<version>::sParseCacheVersion });
+            }
+        }
+        day.SetInputSource(std::move(inputSource));
+    }
+
+    // Every strategy runs on the same parsed input, warmed up and repeated like a benchmark.
+    // The answers are checked against the expected ones and against the reference strategy.
+    template<utility::InputVersion version>
+    static utility::RunReport CompareStrategies(const utility::RunOptions& options)
     {
-        std::cout << Day<>::sDay << '\n';
+        utility::RunReport result;
+        auto& logStream{ utility::GetLogStream(options) };
+        if constexpr (requires { Day<version>::GetStrategies(utility::Part::first); })
+        {
+            Day<version> day;
+            PrepareDay(day, options, options.mInputSource);
+            day.PerformPhase(utility::Phase::readInput);
+            for (const auto& [part, phase] : { std::pair{ utility::Part::first, utility::Phase::first }, std::pair{ utility::Part::second, utility::Phase::second } })
+            {
+                const auto strategies{ Day<version>::GetStrategies(part) };
+                if ((options.mPart != utility::Part::both && options.mPart != part) || strategies.empty())
+                {
+                    continue;
+                }
+
+                std::vector<utility::StrategyResult> strategyResults;
+                for (const auto& strategy : strategies)
+                {
+                    std::vector<utility::Duration> samples;
+                    utility::Result strategyResult;
+                    for (int32_t iteration = 0; iteration < options.mBenchmark.mWarmupIterations + options.mBenchmark.mRepetitions; iteration++)
+                    {
+                        const auto start{ utility::BenchmarkClock::now() };
+                        strategyResult = day.PerformStrategy(phase, strategy.mPerform);
+                        const auto end{ utility::BenchmarkClock::now() };
+                        if (iteration >= options.mBenchmark.mWarmupIterations)
+                        {
+                            samples.push_back(std::chrono::duration_cast<utility::Duration>(end - start));
+                        }
+                    }
 
-        Day<utility::InputVersion::test> testVersion;
-        const auto testStart{ std::chrono::high_resolution_clock::now() };
-        testVersion.Perform(utility::Part::both);
-        const auto testEnd{ std::chrono::high_resolution_clock::now() };
-        std::chrono::nanoseconds testDurationInMilliseconds{ testEnd - testStart };
-        std::cout << "Test took: " << testDurationInMilliseconds.count() << " nanoseconds \n";
+                    auto answer{ utility::ToString(strategyResult) };
+                    const bool isMatchingReference{ strategyResults.empty() || strategyResults.front().mAnswer == answer };
+                    CheckAnswer<version>(options, logStream, part, strategyResult, result);
+                    strategyResults.emplace_back(strategy.mName, utility::CalculateStatistics(std::move(samples)), std::move(answer), isMatchingReference);
+                    if (!isMatchingReference)
+                    {
+                        ++result.mWrongAnswerCount;
+                    }
+                }
+                utility::PrintStrategyComparison(logStream, version, part, strategyResults);
+            }
+        }
+        else
+        {
+            logStream << "[Strategies]: " << Day<version>::sDay << " has only its reference implementation\n";
+        }
+
+        return result;
+    }
 
-        Day<utility::InputVersion::release> releaseVersion;
-        const auto releaseStart{ std::chrono::high_resolution_clock::now() };
-        releaseVersion.Perform(utility::Part::both);
-        const auto releaseEnd{ std::chrono::high_resolution_clock::now() };
-        std::chrono::nanoseconds releaseDurationInMilliseconds{ releaseEnd - releaseStart };
-        std::cout << "Release took: " << releaseDurationInMilliseconds.count() << " nanoseconds\n";
+    template<utility::InputVersion version>
+    static void CheckAnswer(const utility::RunOptions& options, std::ostream& outStream, utility::Part part, const utility::Result& partResult, utility::RunReport& report)
+    {
+        // The expected answers belong to the files of the input directory. An overridden input runs as Release,
+        // and the synthetic keys don't know the size or seed, so neither can be checked.
+        if (options.mInputSource.IsOverridden() || version == utility::InputVersion::synthetic)
+        {
+            return;
+        }
+
+        const auto expectedAnswer{ utility::FindExpectedAnswer(options.mExpectedAnswers, Day<version>::sDay, version, part) };
+        if (!expectedAnswer)
+        {
+            return;
+        }
 
+        ++report.mCheckedAnswerCount;
+        if (const auto answer{ utility::ToString(partResult) }; answer != *expectedAnswer)
+        {
+            ++report.mWrongAnswerCount;
+            outStream << "\033[1;31m" << "[Check]: " << utility::sPartStringMap.at(part) << " part answered " << answer
+                << " but " << *expectedAnswer << " is expected" << "\033[0m" << '\n';
+        }
+    }
+
+    struct PhaseMeasurements
+    {
+        utility::PhaseSamples mSamples;
+        std::array<utility::Result, utility::sPhaseOrder.size()> mResults;
+        std::array<std::vector<utility::CounterValues>, utility::sPhaseOrder.size()> mCounters;
+        std::array<std::vector<utility::AllocationStatistics>, utility::sPhaseOrder.size()> mAllocations;
     };
+
+    // Every iteration runs on a fresh instance, as ReadInput appends to the members.
+    // The counters are started outside of the timed region, so reading them doesn't show up in the wall time.
+    template<utility::InputVersion version>
+    [[nodiscard]] PhaseMeasurements MeasurePhases(const utility::RunOptions& runOptions, utility::PerformanceCounters* counters = nullptr)
+    {
+        PhaseMeasurements result;
+        Day<version> day;
+        PrepareDay(day, runOptions, runOptions.mInputSource);
+        for (const auto phase : utility::GetPhasesOfPart(runOptions.mPart))
+        {
+            if (counters)
+            {
+                counters->Start();
+            }
+            std::optional<utility::AllocationScope> allocationScope;
+            if constexpr (utility::sIsAllocationTrackingEnabled)
+            {
+                allocationScope.emplace();
+            }
+            const auto start{ utility::BenchmarkClock::now() };
+            auto phaseResult{ day.PerformPhase(phase) };
+            const auto end{ utility::BenchmarkClock::now() };
+            if (allocationScope)
+            {
+                result.mAllocations[utility::GetPhaseIndex(phase)].push_back(allocationScope->Stop());
+            }
+            if (counters)
+            {
+                result.mCounters[utility::GetPhaseIndex(phase)].push_back(counters->Stop());
+            }
+            result.mSamples[utility::GetPhaseIndex(phase)].push_back(std::chrono::duration_cast<utility::Duration>(end - start));
+            result.mResults[utility::GetPhaseIndex(phase)] = std::move(phaseResult);
+        }
+
+        return result;
+    }
+
+    template<utility::InputVersion version>
+    [[nodiscard]] utility::RunReport Benchmark(const utility::RunOptions& runOptions)
+    {
+        const auto part{ runOptions.mPart };
+        const auto& options{ runOptions.mBenchmark };
+        for (int32_t iteration = 0; iteration < options.mWarmupIterations; iteration++)
+        {
+            std::ignore = MeasurePhases<version>(runOptions);
+        }
+
+        std::optional<utility::PerformanceCounters> counters;
+        if (options.mCounters)
+        {
+            counters.emplace();
+        }
+
+        PhaseMeasurements measurements;
+        for (int32_t iteration = 0; iteration < options.mRepetitions; iteration++)
+        {
+            auto iterationMeasurements{ MeasurePhases<version>(runOptions, counters ? &*counters : nullptr) };
+            for (const auto phase : utility::sPhaseOrder)
+            {
+                auto& phaseSamples{ measurements.mSamples[utility::GetPhaseIndex(phase)] };
+                const auto& iterationPhaseSamples{ iterationMeasurements.mSamples[utility::GetPhaseIndex(phase)] };
+                phaseSamples.insert(phaseSamples.end(), iterationPhaseSamples.begin(), iterationPhaseSamples.end());
+
+                auto& phaseCounters{ measurements.mCounters[utility::GetPhaseIndex(phase)] };
+                const auto& iterationPhaseCounters{ iterationMeasurements.mCounters[utility::GetPhaseIndex(phase)] };
+                phaseCounters.insert(phaseCounters.end(), iterationPhaseCounters.begin(), iterationPhaseCounters.end());
+
+                auto& phaseAllocations{ measurements.mAllocations[utility::GetPhaseIndex(phase)] };
+                const auto& iterationPhaseAllocations{ iterationMeasurements.mAllocations[utility::GetPhaseIndex(phase)] };
+                phaseAllocations.insert(phaseAllocations.end(), iterationPhaseAllocations.begin(), iterationPhaseAllocations.end());
+            }
+            measurements.mResults = std::move(iterationMeasurements.mResults);
+        }
+
+        auto& logStream{ utility::GetLogStream(runOptions) };
+        logStream << "[Version]: " << utility::sInputVersionStringMap.at(version) << " [Part]: " << utility::sPartStringMap.at(part)
+            << " warmup: " << options.mWarmupIterations << " repetitions: " << options.mRepetitions << '\n';
+        utility::PrintStatisticsHeader(logStream);
+
+        utility::RunReport result;
+        const auto inputSize{ utility::InputReader<Day<version>, version>{ runOptions.mInputSource }.GetSize() };
+        for (const auto phase : utility::GetPhasesOfPart(part))
+        {
+            auto& record{ result.mRecords.emplace_back(Day<version>::sDay, version, phase,
+                utility::CalculateStatistics(measurements.mSamples[utility::GetPhaseIndex(phase)])) };
+            if (const auto& phaseResult{ measurements.mResults[utility::GetPhaseIndex(phase)] }; utility::HasValue(phaseResult))
+            {
+                record.mResult = utility::ToString(phaseResult);
+            }
+            record.mInputSize = inputSize;
+            record.mSamples = std::move(measurements.mSamples[utility::GetPhaseIndex(phase)]);
+            if (counters)
+            {
+                record.mCounters = utility::AverageCounterValues(measurements.mCounters[utility::GetPhaseIndex(phase)]);
+            }
+            if constexpr (utility::sIsAllocationTrackingEnabled)
+            {
+                record.mAllocations = utility::AverageAllocationStatistics(measurements.mAllocations[utility::GetPhaseIndex(phase)]);
+            }
+            utility::PrintStatistics(logStream, phase, record.mStatistics);
+        }
+
+        if (counters)
+        {
+            if (!counters->HasHardwareCounters())
+            {
+                logStream << "[Counters]: hardware counters aren't available here, only CPU time and context switches are counted\n";
+            }
+            utility::PrintCountersHeader(logStream);
+            for (const auto& record : result.mRecords)
+            {
+                utility::PrintCounters(logStream, record.mPhase, *record.mCounters);
+            }
+        }
+
+        if constexpr (utility::sIsAllocationTrackingEnabled)
+        {
+            utility::PrintAllocationsHeader(logStream);
+            for (const auto& record : result.mRecords)
+            {
+                utility::PrintAllocations(logStream, record.mPhase, *record.mAllocations);
+            }
+        }
+
+        for (const auto [phase, part] : { std::pair{ utility::Phase::first, utility::Part::first }, std::pair{ utility::Phase::second, utility::Part::second } })
+        {
+            if (const auto& phaseResult{ measurements.mResults[utility::GetPhaseIndex(phase)] }; utility::HasValue(phaseResult))
+            {
+                CheckAnswer<version>(runOptions, logStream, part, phaseResult, result);
+            }
+        }
+
+        return result;
+    }
+
+    // Benchmarks the synthetic input at every scaling size and fits the growth of every phase.
+    // The records of every size are returned, they can be told apart by their input size.
+    [[nodiscard]] std::vector<utility::BenchmarkRecord> Scale(const utility::RunOptions& runOptions)
+    {
+        constexpr auto sVersion{ utility::InputVersion::synthetic };
+        auto& settings{ utility::GetSyntheticInputSettings() };
+        const auto previousSize{ settings.mSize };
+        auto& logStream{ utility::GetLogStream(runOptions) };
+
+        std::vector<utility::BenchmarkRecord> result;
+        std::array<std::vector<utility::ScalingPoint>, utility::sPhaseOrder.size()> phasePoints;
+        for (const auto size : utility::GetScalingSizes(runOptions.mScaling))
+        {
+            settings.mSize = size;
+            auto records{ Benchmark<sVersion>(runOptions).mRecords };
+            for (const auto& record : records)
+            {
+                phasePoints[utility::GetPhaseIndex(record.mPhase)].emplace_back(static_cast<double>(record.mInputSize.value_or(size)), record.mStatistics.mMedian);
+            }
+            result.insert(result.end(), std::make_move_iterator(records.begin()), std::make_move_iterator(records.end()));
+        }
+        settings.mSize = previousSize;
+
+        logStream << "[Scaling]: " << Day<>::sDay << " median per input size\n";
+        for (const auto phase : utility::GetPhasesOfPart(runOptions.mPart))
+        {
+            utility::PrintScalingPoints(logStream, phase, phasePoints[utility::GetPhaseIndex(phase)]);
+        }
+        utility::PrintScalingFitHeader(logStream);
+        for (const auto phase : utility::GetPhasesOfPart(runOptions.mPart))
+        {
+            utility::PrintScalingFit(logStream, phase, utility::FitScaling(phasePoints[utility::GetPhaseIndex(phase)]), runOptions.mScaling);
+        }
+
+        return result;
+    }
+
+    std::tuple<PrefetchedDay<utility::InputVersion::release>, PrefetchedDay<utility::InputVersion::test>,
+        PrefetchedDay<utility::InputVersion::synthetic>> mPrefetchedDays;
 };
\ No newline at end of file
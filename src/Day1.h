@@ -11,39 +11,65 @@ class Day1 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day1" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
+    void ReadLine(std::string_view numbersInString)
+    {
+        using namespace std::literals;
+        for (const auto [index, value] : numbersInString | std::ranges::views::split("   "sv)
+            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; })
+            | std::ranges::views::enumerate)
+        {
+            if (index == 0)
+            {
+                mFirstNumbers.emplace_back(utility::ToNumber(value));
+            }
+            else if (index == 1)
+            {
+                mSecondNumbers.emplace_back(utility::ToNumber(value));
+            }
+            else
+            {
+                assert(false);
+            }
+        }
+    }
+
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day1, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto numbersInString : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+        utility::InputReader<Day1, version> inputReader{ this->GetInputSource() };
+        if (this->GetInputSource().mIsStreaming)
+        {
+            inputReader.ForEachRecord("\n", [this](std::string_view line) { ReadLine(line); });
+        }
+        else
         {
-            for (const auto [index, value] : numbersInString | std::ranges::views::split("   "sv)
-                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; })
-                | std::ranges::views::enumerate)
+            mInput = inputReader.Map();
+            mBuffer = mInput.GetView();
+            for (const auto numbersInString : mBuffer | std::ranges::views::split("\n"sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
             {
-                if (index == 0)
-                {
-                    mFirstNumbers.emplace_back(utility::ToNumber(value));
-                }
-                else if (index == 1)
-                {
-                    mSecondNumbers.emplace_back(utility::ToNumber(value));
-                }
-                else
-                {
-                    assert(false);
-                }
+                ReadLine(numbersInString);
             }
         }
         std::ranges::sort(mFirstNumbers, std::less<int32_t>{});
         std::ranges::sort(mSecondNumbers, std::less<int32_t>{});
     };
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mFirstNumbers, mSecondNumbers);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mFirstNumbers, mSecondNumbers);
+    }
+
+    utility::Result PerformFirst() override
     {
         int32_t result{};
         for (const auto [firstListElement, secondListElement] : std::ranges::views::zip(mFirstNumbers, mSecondNumbers))
@@ -51,11 +77,10 @@ private:
             result += std::abs(firstListElement - secondListElement);
         }
 
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << "\n";
+        return result;
     };
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         int32_t result{};
 
@@ -79,12 +104,12 @@ private:
             secondListNextLowerBoundIterator = upperBound;
         }
 
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << "\n";
+        return result;
     };
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<int32_t> mFirstNumbers;
     std::vector<int32_t> mSecondNumbers;
 };
@@ -1,9 +1,11 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
 
 #include <ranges>
 #include <vector>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
 #include <variant>
@@ -16,88 +18,90 @@ class Day10 : public DayBase<version>
     using PositionIndex = int32_t;
     using Height = int8_t;
     using Position = utility::Position<PositionIndex>;
+    using Grid = utility::Grid<Height>;
+    using Index = Grid::Index;
 
+    // below the lowest height, no trail climbs onto it, so none leaves the map
+    static constexpr Height sBorderHeight{ -1 };
+
+    // Allocator aware, so a pmr vector of them hands its arena down to the peaks.
     struct ScratchData
     {
-        std::vector<Position> mFoundPeeks;
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        explicit ScratchData(const allocator_type& allocator) : mFoundPeeks{ allocator } {}
+        ScratchData(ScratchData&& other, const allocator_type& allocator) : mFoundPeeks{ std::move(other.mFoundPeeks), allocator } {}
+
+        std::pmr::vector<Index> mFoundPeeks;
     };
 
 public:
     static constexpr std::string_view sDay{ "day10" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 
 private:
 
     template<bool starting = false>
-    void TraverseTrail(Position position, utility::DirectionData fromDirection, Height previousHeight, ScratchData& scratchData, PositionIndex maximumSlope = 1)
+    void TraverseTrail(Index index, Index fromOffset, Height previousHeight, ScratchData& scratchData, PositionIndex maximumSlope = 1)
     {
-        static constexpr Position sEmptyDirection{ 0,0 };
-        auto currentHeight{ utility::GetItemAt(mData,position) };
-        Height currentHeightValue{};
-        if (currentHeight.has_value())
+        const auto currentHeightValue{ mData[index] };
+        if (!starting && previousHeight + maximumSlope != currentHeightValue)
         {
-            currentHeightValue = *currentHeight.value();
-            if (!starting && previousHeight + maximumSlope != currentHeightValue)
-            {
-                return;
-            }
-            if (currentHeightValue == static_cast<int8_t>(9))
-            {
-                scratchData.mFoundPeeks.emplace_back(position);
-                return;
-            }
+            return;
         }
-        else
+        if (currentHeightValue == static_cast<int8_t>(9))
         {
-            // Out of bounds
+            scratchData.mFoundPeeks.emplace_back(index);
             return;
         }
 
-        for (auto [direction, offset] : utility::sBaseDirectionsMap)
-        {
-            // optional implicitly checked
-            if (fromDirection == offset)
+        utility::ForEachNeighbor<utility::sBaseDirections>(index, mData.GetStride(), [&](utility::Direction, Index neighbour)
             {
-                continue;
-            }
-            auto oppositeOffset{ offset * -1 };
+                if (neighbour - index == fromOffset)
+                {
+                    return;
+                }
 
-            TraverseTrail<false>(position + offset, oppositeOffset, currentHeightValue, scratchData, maximumSlope);
-        }
+                TraverseTrail<false>(neighbour, index - neighbour, currentHeightValue, scratchData, maximumSlope);
+            });
     }
 
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day10, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto [index, rowInput] : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }) | std::ranges::views::enumerate)
+        utility::InputReader<Day10, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mData = Grid::FromLines(mBuffer, [](char character) { return utility::ToNumber<Height>(character); }, 1, sBorderHeight);
+        for (const auto [index, row] : mData.GetRows() | std::ranges::views::enumerate)
         {
-            mData.emplace_back();
-            auto& row{ mData.back() };
-            row.reserve(rowInput.size());
-            for (const auto character : rowInput)
+            for (const auto [colIndex, height] : row | std::ranges::views::enumerate)
             {
-                if (character == '\0')
-                {
-                    continue;
-                }
-
-                row.emplace_back(utility::ToNumber<Height>(character));
-                if (character == '0')
+                if (height == 0)
                 {
-                    mTrailheads.push_back(Position{ static_cast<PositionIndex>(index), static_cast<PositionIndex>(row.size() - 1) });
+                    mTrailheads.push_back(Position{ static_cast<PositionIndex>(index), static_cast<PositionIndex>(colIndex) });
                 }
             }
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData, mTrailheads);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData, mTrailheads);
+    }
+
+    utility::Result PerformFirst() override
     {
-        std::vector<ScratchData> scratchDatas(mTrailheads.size());
+        std::pmr::vector<ScratchData> scratchDatas(mTrailheads.size(), this->GetScratchResource());
         for (auto&& [position, scratchData] : std::ranges::views::zip(mTrailheads, scratchDatas))
         {
-            TraverseTrail<true>(position, Position{ 0,0 }, 0, scratchData);
+            TraverseTrail<true>(mData.GetIndex(position), 0, 0, scratchData);
         }
         Number result{};
         for (auto& scratchData : scratchDatas)
@@ -107,28 +111,27 @@ private:
             scratchData.mFoundPeeks.erase(firstToErase, lastToErase);
             result += scratchData.mFoundPeeks.size();
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
-        std::vector<ScratchData> scratchDatas(mTrailheads.size());
+        std::pmr::vector<ScratchData> scratchDatas(mTrailheads.size(), this->GetScratchResource());
         for (auto&& [position, scratchData] : std::ranges::views::zip(mTrailheads, scratchDatas))
         {
-            TraverseTrail<true>(position, Position{ 0,0 }, 0, scratchData);
+            TraverseTrail<true>(mData.GetIndex(position), 0, 0, scratchData);
         }
         Number result{};
         for (auto& scratchData : scratchDatas)
         {
             result += scratchData.mFoundPeeks.size();
         }
-        std::cout << result << '\n';
-        utility::PrintDetails(version, utility::Part::second);
+        return result;
     }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<Height>> mData;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    Grid mData;
     std::vector<Position> mTrailheads;
 };
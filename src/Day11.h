@@ -1,9 +1,11 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "ThreadPool.h"
 
 #include <ranges>
 #include <vector>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
 #include <variant>
@@ -17,17 +19,12 @@ class Day11 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day11" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
     using Number = uint64_t;
     using Vector = std::vector<Number>;
-    using Cache = std::unordered_map<Number, Number>;
-
-    struct ScratchData
-    {
-        Vector mNumberResults;
-        std::mutex mLock;
-    };
+    using Cache = std::pmr::unordered_map<Number, Number>;
 
     enum class Rule
     {
@@ -129,17 +126,18 @@ private:
 
     Number GetNumberOfStonesInBlinks(const Vector& stones, Number numberOfBlinks)
     {
-        ScratchData scratchData;
-        std::vector<std::thread> workers;
-        workers.reserve(stones.size());
-        for (auto&& [index, number] : stones | std::ranges::views::enumerate)
-        {
-            workers.emplace_back([=, this, &scratchData] {
-                Cache cache;
+        // every stone blinks independently, each one writes its own slot
+        Vector stoneResults(stones.size());
+        utility::ParallelFor(0, stones.size(), [&, this](size_t stoneIndex)
+            {
+                const auto number{ stones[stoneIndex] };
+                utility::ThreadScratchScope scratchScope;
+                Cache cache{ scratchScope.GetResource() };
                 cache.try_emplace(number, 1);
                 for (Number blink = 1; blink <= numberOfBlinks; ++blink)
                 {
-                    Cache newCache;
+                    utility::ScopedZone zone{ "Blink", sDay };
+                    Cache newCache{ scratchScope.GetResource() };
                     newCache.reserve(cache.size());
                     for (const auto& [stoneNumber, stoneCount] : cache)
                     {
@@ -150,24 +148,19 @@ private:
                 }
 
                 auto sumCount = [](auto sum, auto pair)->Number {return sum + pair.second; };
-                Number result{ std::reduce(cache.begin(), cache.end(), Number{0}, sumCount) };
-                std::unique_lock<std::mutex> lock{ scratchData.mLock };
-                scratchData.mNumberResults.push_back(result);
-                std::cout << "WorkerIndex: " << index << " Blinked: " << numberOfBlinks << '\n';
-                std::cout << "StoneNumber: " << number << " Resulted In: " << result << "\n";
-                });
-        }
+                stoneResults[stoneIndex] = std::reduce(cache.begin(), cache.end(), Number{0}, sumCount);
+            }, 1);
 
-        std::ranges::for_each(workers, &std::thread::join);
-        Number result{ std::reduce(scratchData.mNumberResults.begin(), scratchData.mNumberResults.end()) };
+        Number result{ std::reduce(stoneResults.begin(), stoneResults.end()) };
         return result;
     }
 
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day11, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day11, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
             | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
         {
@@ -175,21 +168,31 @@ private:
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mStones);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mStones);
+    }
+
+    utility::Result PerformFirst() override
     {
         const auto result{ GetNumberOfStonesInBlinks(mStones,25) };
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         const auto result{ GetNumberOfStonesInBlinks(mStones,75) };
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     Vector mStones;
 };
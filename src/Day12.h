@@ -1,6 +1,8 @@
 #pragma once
 #include "Utility.h"
+#include "BitGrid.h"
 #include "Day.h"
+#include "Grid.h"
 
 #include <ranges>
 #include <span>
@@ -11,13 +13,17 @@ class Day12 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day12" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 
 private:
     using Number = uint64_t;
     using PositionType = int32_t;
     using Position = utility::Position<PositionType>;
     using PlotType = char;
-    using VisitedFieldVector = std::vector<std::vector<bool>>;
+    using Grid = utility::Grid<PlotType>;
+    using VisitedFields = utility::BitGrid<>;
+
+    static constexpr PlotType sBorderPlot{ '.' };
 
     struct Region
     {
@@ -48,83 +54,61 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day12, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
-        {
-            mPlotGrid.emplace_back();
-            auto& row{ mPlotGrid.back() };
-            row.reserve(rowInput.size());
-            for (const auto character : rowInput)
-            {
-                if (character == '\0')
-                {
-                    continue;
-                }
-
-                row.emplace_back(character);
-            }
-        }
-
-        assert(!mPlotGrid.empty());
-        VisitedFieldVector visitedFields(mPlotGrid.size(), std::vector<bool>(mPlotGrid[0].size(), false));
-        for (auto [rowIndex, row] : mPlotGrid | std::ranges::views::enumerate)
+        utility::InputReader<Day12, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mPlotGrid = Grid::FromLines(mBuffer, [](char character) { return character; }, 1, sBorderPlot);
+
+        assert(!mPlotGrid.IsEmpty());
+        VisitedFields visitedFields{ mPlotGrid.GetRowCount(), mPlotGrid.GetColumnCount() };
+        for (auto [rowIndex, row] : mPlotGrid.GetRows() | std::ranges::views::enumerate)
         {
             for (auto [colIndex, plotType] : row | std::ranges::views::enumerate)
             {
-                if (visitedFields[rowIndex][colIndex])
+                const Position position{ static_cast<int32_t>(rowIndex),static_cast<int32_t>(colIndex) };
+                if (visitedFields.Test(position))
                 {
                     continue;
                 }
 
                 auto& regionIterator{ mRegions.emplace_back(plotType) };
-                GatherFieldsOfRegion({ static_cast<int32_t>(rowIndex),static_cast<int32_t>(colIndex) }, regionIterator, visitedFields);
+                GatherFieldsOfRegion(position, regionIterator, visitedFields);
             }
         }
     }
 
-    void GatherFieldsOfRegion(Position position, Region& region, VisitedFieldVector& visitedFields)
+    // the border matches no plot type, so the region never grows out of the map
+    void GatherFieldsOfRegion(Position position, Region& region, VisitedFields& visitedFields)
     {
-        auto currentField{ utility::GetItemAt(mPlotGrid, position) };
-        if (!currentField.has_value())
-        {
-            return;     // out of bounds
-        }
-
-        const auto currentFieldValue{ *currentField.value() };
-        if (currentFieldValue != region.mPlotType)
-        {
-            return;
-        }
-
-        auto visitedFieldValue{ visitedFields[position.mRow][position.mCol] };
-        if (visitedFieldValue)
+        if (mPlotGrid[position] != region.mPlotType || visitedFields.TestAndSet(position))
         {
             return;
         }
 
-        visitedFieldValue = true;
         region.mPositions.push_back(position);
 
-        for (auto offset : utility::sBaseDirectionsMap | std::ranges::views::values)
-        {
-            auto offsetPosition = position + offset;
-            GatherFieldsOfRegion(offsetPosition, region, visitedFields);
-        }
+        utility::ForEachNeighbor<utility::sBaseDirections>(position, [&](utility::Direction, Position offsetPosition)
+            {
+                GatherFieldsOfRegion(offsetPosition, region, visitedFields);
+            });
+    }
+
+    // A neighbour of the same plot type is part of the same region, a region is all of the plots it reaches.
+    [[nodiscard]] bool IsPartOfRegion(const Region& region, Position position) const
+    {
+        return mPlotGrid[position] == region.mPlotType;
     }
 
     Number GetNumberOfOpenEdges(const Region& region, Position position)
     {
         Number openEdges{ 0 };
-        for (auto offset : utility::sBaseDirectionsMap | std::ranges::views::values)
-        {
-            auto offsetPosition = position + offset;
-            if (std::ranges::find(region.mPositions, offsetPosition) == region.mPositions.end())
+        utility::ForEachNeighbor<utility::sBaseDirections>(position, [&](utility::Direction, Position offsetPosition)
             {
-                ++openEdges;
-            }
-        }
+                if (!IsPartOfRegion(region, offsetPosition))
+                {
+                    ++openEdges;
+                }
+            });
 
         return openEdges;
     }
@@ -143,21 +127,20 @@ private:
     std::vector<Edge> GetEdges(const Region& region, Position position)
     {
         std::vector<Edge> edges;
-        for (auto [direction, offset] : utility::sBaseDirectionsMap)
-        {
-            auto offsetPosition = position + offset;
-            if (std::ranges::find(region.mPositions, offsetPosition) == region.mPositions.end())
+        utility::ForEachNeighbor<utility::sBaseDirections>(position, [&](utility::Direction direction, Position offsetPosition)
             {
-                if (direction == utility::Direction::left || direction == utility::Direction::right)
-                {
-                    edges.emplace_back(offsetPosition, EdgeType::vertical, direction);
-                }
-                else
+                if (!IsPartOfRegion(region, offsetPosition))
                 {
-                    edges.emplace_back(offsetPosition, EdgeType::horizontal, direction);
+                    if (direction == utility::Direction::left || direction == utility::Direction::right)
+                    {
+                        edges.emplace_back(offsetPosition, EdgeType::vertical, direction);
+                    }
+                    else
+                    {
+                        edges.emplace_back(offsetPosition, EdgeType::horizontal, direction);
+                    }
                 }
-            }
-        }
+            });
 
         return edges;
     }
@@ -168,7 +151,7 @@ private:
         PositionType Position::* otherAxis{ edgeType == EdgeType::horizontal ? &Position::mRow : &Position::mCol };
         std::ranges::sort(edges, [=](const auto& edgeA, const auto& edgeB)
             {
-                return edgeA.mPosition.*inspectedAxis <= edgeB.mPosition.*inspectedAxis;
+                return edgeA.mPosition.*inspectedAxis < edgeB.mPosition.*inspectedAxis;
             }
         );
 
@@ -233,7 +216,36 @@ private:
         return numberOfHorizontalEdges + numberOfHorizontalEdges;
     }
 
-    void PerformFirst() override
+    // regions go through pairs, the reader only knows standard types
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        std::vector<std::pair<PlotType, std::vector<Position>>> regions;
+        regions.reserve(mRegions.size());
+        for (const auto& region : mRegions)
+        {
+            regions.emplace_back(region.mPlotType, region.mPositions);
+        }
+        writer.Write(mPlotGrid, regions);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        std::vector<std::pair<PlotType, std::vector<Position>>> regions;
+        if (!reader.ReadAll(mPlotGrid, regions))
+        {
+            return false;
+        }
+
+        mRegions.reserve(regions.size());
+        for (auto& [plotType, positions] : regions)
+        {
+            mRegions.emplace_back(plotType, std::move(positions));
+        }
+        return true;
+    }
+
+    utility::Result PerformFirst() override
     {
         Number result{};
         for (auto&& region : mRegions)
@@ -242,26 +254,23 @@ private:
             result += area * perimeter;
         }
 
-        utility::PrintDetails(version, utility::Part::first);
-        utility::PrintResult(result);
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         Number result{};
         for (auto&& region : mRegions)
         {
             const auto sides{ CalculatePlotSides(region) };
             result += region.mPositions.size() * sides;
-            std::cout << "Region: " << region.mPlotType << " Area: " << region.mPositions.size() 
-                << " Sides: " << sides << " = " << region.mPositions.size() * sides << '\n';
         }
-        utility::PrintDetails(version, utility::Part::second);
-        utility::PrintResult(result);
+        return result;
     }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<PlotType>> mPlotGrid;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    Grid mPlotGrid;
     std::vector<Region> mRegions;
 };
@@ -2,6 +2,7 @@
 #include "Utility.h"
 #include "Day.h"
 
+#include <array>
 #include <ranges>
 #include <span>
 #include <vector>
@@ -11,6 +12,7 @@ class Day13 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day13" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
     using Number = uint64_t;
@@ -54,21 +56,46 @@ private:
 
     // Numbers are all positive.
     // only additions occur
+    void ReadSlotMachine(std::string_view rowInput)
+    {
+        std::array<Number, 6> numbers{};
+        [[maybe_unused]] const auto count{ utility::ScanNumbers(rowInput, std::span{ numbers }) };
+        assert(count == numbers.size());
+        mSlotMachines.emplace_back(Position{ numbers[0], numbers[1] }, Position{ numbers[2], numbers[3] }, Position{ numbers[4], numbers[5] });
+    }
+
+    // Slot machines are separated by an empty line, so streaming splits on that instead of on lines.
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day13, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day13, version> inputReader{ this->GetInputSource() };
+        if (this->GetInputSource().mIsStreaming)
+        {
+            inputReader.ForEachRecord("\n\n", [this](std::string_view slotMachine) { ReadSlotMachine(slotMachine); });
+            return;
+        }
+
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         for (const auto rowInput : mBuffer | std::ranges::views::split("\n\n"sv)
             | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
         {
-            auto numbers{ utility::GetNumbers<Number>(rowInput) };
-            assert(numbers.size() == 6);
-            mSlotMachines.emplace_back(Position{ numbers[0], numbers[1] }, Position{ numbers[2], numbers[3] }, Position{ numbers[4], numbers[5] });
+            ReadSlotMachine(rowInput);
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mSlotMachines);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mSlotMachines);
+    }
+
+    utility::Result PerformFirst() override
     {
         Number result{};
         for (const auto& slotMachine : mSlotMachines)
@@ -76,11 +103,10 @@ private:
             auto winningMovePrice{ GetWinningClawMove(slotMachine, 0) };
             result += winningMovePrice;
         }
-        utility::PrintDetails(version, utility::Part::first);
-        utility::PrintResult(result);
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         Number result{};
         for (const auto& slotMachine : mSlotMachines)
@@ -88,11 +114,11 @@ private:
             auto winningMovePrice{ GetWinningClawMove(slotMachine, 1'000'000'000'000'0) };
             result += winningMovePrice;
         }
-        utility::PrintDetails(version, utility::Part::second);
-        utility::PrintResult(result);
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<SlotMachine> mSlotMachines;
 };
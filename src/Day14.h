@@ -1,9 +1,12 @@
 #pragma once
 #include "Utility.h"
+#include "BitGrid.h"
 #include "Day.h"
 
+#include <array>
 #include <ranges>
 #include <vector>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
 
@@ -17,6 +20,7 @@ class Day14 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day14" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
     using Number = int32_t;
@@ -35,11 +39,15 @@ private:
         Velocity mVelocity;
     };
 
+    // mOccupied has a bit per tile with a robot on it, MarkOccupiedTiles fills it for the current positions
     struct ScratchData
     {
-        std::vector<RobotData> mData;
+        std::pmr::vector<RobotData> mData;
+        utility::pmr::BitGrid mOccupied;
     };
 
+    using VisitedFields = utility::pmr::BitGrid;
+
     void CorrectRobotPositionIfNeeded(Number& robotPos, Number minimumBound, Number maximumBound)
     {
         if (robotPos > maximumBound)
@@ -112,91 +120,78 @@ private:
         return quadrants;
     }
 
-    void PrintRobots(ScratchData& scratchData, std::ostream& outStream)
+    void MarkOccupiedTiles(ScratchData& scratchData)
     {
-        for (Number row = mTileBound.mMinimum.mRow; row < mTileBound.mMaximum.mRow; row++)
+        scratchData.mOccupied.Clear();
+        for (const auto& robotData : scratchData.mData)
         {
-            for (Number col = mTileBound.mMinimum.mCol; col < mTileBound.mMaximum.mCol; col++)
-            {
-                if (std::ranges::find(scratchData.mData, Position{ .mRow = row, .mCol = col }, &RobotData::mPosition) != scratchData.mData.end())
-                {
-                    outStream << '#';
-                }
-                else
-                {
-                    outStream << ' ';
-                }
-            }
-            outStream << '\n';
+            scratchData.mOccupied.Set(robotData.mPosition);
         }
     }
 
     bool HasRobotOnPoint(ScratchData& scratchData, Position position)
     {
-        return std::ranges::find(scratchData.mData, position, &RobotData::mPosition) != scratchData.mData.end();
-    }
-
-    bool AllMiddlePointsOccupied(ScratchData& scratchData)
-    {
-        bool result{ true };
-        Number middleCol{ mTileBound.mMaximum.mCol / 2 };
-        for (auto [index, row] : scratchData.mData | std::ranges::views::enumerate)
-        {
-            if (!HasRobotOnPoint(scratchData, Position{ .mRow = static_cast<Number>(index), .mCol = middleCol }))
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return scratchData.mOccupied.Test(position);
     }
 
-    Number GetLargestContiguousBlock(ScratchData& scratchData, std::vector<std::vector<bool>>& visitedFields)
+    // A block has a robot on every tile, so only the robots' tiles can start one.
+    Number GetLargestContiguousBlock(ScratchData& scratchData, VisitedFields& visitedFields)
     {
         Number result{ 0 };
-        for (Number row = 0; row < mTileBound.mMaximum.mRow; row++)
+        for (const auto& robotData : scratchData.mData)
         {
-            for (Number col = 0; col < mTileBound.mMaximum.mCol; col++)
-            {
-                Number currentResult{};
-                GetLargestContiguousBlock(scratchData, visitedFields, { row,col }, currentResult);
-                result = std::max(currentResult, result);
-            }
+            Number currentResult{};
+            GetLargestContiguousBlock(scratchData, visitedFields, robotData.mPosition, currentResult);
+            result = std::max(currentResult, result);
         }
 
         return result;
     }
 
-    void GetLargestContiguousBlock(ScratchData& scratchData, std::vector<std::vector<bool>>& visitedFields, Position position, Number& currentResult)
+    void GetLargestContiguousBlock(ScratchData& scratchData, VisitedFields& visitedFields, Position position, Number& currentResult)
     {
-        if (!IsInsideOfAABB(position, mTileBound) || visitedFields[position.mRow][position.mCol])
+        if (!IsInsideOfAABB(position, mTileBound) || visitedFields.TestAndSet(position))
         {
             return;
         }
 
-        visitedFields[position.mRow][position.mCol] = true;
         if (!HasRobotOnPoint(scratchData, position))
         {
             return;
         }
 
         ++currentResult;
-        for (auto& offset : utility::sFullDirectionsMap | std::ranges::views::values)
-        {
-            GetLargestContiguousBlock(scratchData, visitedFields, position + offset, currentResult);
-        }
+        utility::ForEachNeighbor<utility::sFullDirections>(position, [&](utility::Direction, Position neighbour)
+            {
+                GetLargestContiguousBlock(scratchData, visitedFields, neighbour, currentResult);
+            });
+    }
+
+    void ReadLine(std::string_view rowInput)
+    {
+        std::array<Number, 4> robotStats{};
+        [[maybe_unused]] const auto count{ utility::ScanNumbers(rowInput, std::span{ robotStats }) };
+        assert(count == robotStats.size());
+        mRobotData.emplace_back(Position{ robotStats[1],robotStats[0] }, Velocity{ robotStats[3],robotStats[2] });
     }
 
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day14, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+        utility::InputReader<Day14, version> inputReader{ this->GetInputSource() };
+        if (this->GetInputSource().mIsStreaming)
         {
-            auto robotStats{ utility::GetNumbers<Number>(rowInput) };
-            mRobotData.emplace_back(Position{ robotStats[1],robotStats[0] }, Velocity{ robotStats[3],robotStats[2] });
+            inputReader.ForEachRecord("\n", [this](std::string_view line) { ReadLine(line); });
+        }
+        else
+        {
+            mInput = inputReader.Map();
+            mBuffer = mInput.GetView();
+            for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+            {
+                ReadLine(rowInput);
+            }
         }
 
         if (version == utility::InputVersion::test)
@@ -211,10 +206,20 @@ private:
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mRobotData, mTileBound);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mRobotData, mTileBound);
+    }
+
+    utility::Result PerformFirst() override
     {
-        ScratchData scratchData;
-        scratchData.mData = mRobotData;
+        ScratchData scratchData{ { mRobotData.begin(), mRobotData.end(), this->GetScratchResource() } };
         UpdateRobotPositions(scratchData, 100);
         const auto quadrantBoundingBoxes{ GetQuadrants(mTileBound) };
         std::vector<Number> numberOfRobotsInQuadrant{};
@@ -225,49 +230,37 @@ private:
         }
 
         Number result{ std::reduce(numberOfRobotsInQuadrant.begin(),numberOfRobotsInQuadrant.end(),Number{1}, [](auto sum, auto value)->Number {return value > 0 ? sum * value : sum; }) };
-        utility::PrintDetails(version, utility::Part::first);
-        utility::PrintResult(result);
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
-        utility::PrintDetails(version, utility::Part::second);
-        ScratchData scratchData;
-        scratchData.mData = mRobotData;
-        Number numToAdvance{};
-        Number numberOfAdvancements{};
-
-        std::vector<std::vector<bool>> visitedFields(mTileBound.mMaximum.mRow + day14::helper::sOffByOne, std::vector<bool>(mTileBound.mMaximum.mCol + day14::helper::sOffByOne, false));
-        while (std::cin >> numToAdvance)
+        const Number rowCount{ mTileBound.mMaximum.mRow + day14::helper::sOffByOne };
+        const Number columnCount{ mTileBound.mMaximum.mCol + day14::helper::sOffByOne };
+        ScratchData scratchData{ { mRobotData.begin(), mRobotData.end(), this->GetScratchResource() }, utility::pmr::BitGrid{ rowCount, columnCount, this->GetScratchResource() } };
+
+        // The robots are back at their start after width * height advancements, so the picture has to show up before.
+        // A fifth of the robots in one contiguous block is taken as the picture.
+        const Number numberOfStates{ rowCount * columnCount };
+        VisitedFields visitedFields{ rowCount, columnCount, this->GetScratchResource() };
+        for (Number numberOfAdvancements = 0; numberOfAdvancements < numberOfStates; numberOfAdvancements++)
         {
-            if (numToAdvance == 0)
+            MarkOccupiedTiles(scratchData);
+            if (scratchData.mData.size() / 5 <= GetLargestContiguousBlock(scratchData, visitedFields))
             {
-                break;
+                return numberOfAdvancements;
             }
 
-            for (int i = 0; i < numToAdvance; i++)
-            {
-                while (scratchData.mData.size() / 5 > GetLargestContiguousBlock(scratchData, visitedFields))
-                {
-                    numberOfAdvancements++;
-                    UpdateRobotPositions(scratchData, 1);
-
-                    // Clear visited fields 
-                    for (auto& boolVec : visitedFields)
-                    {
-                        boolVec.clear();
-                        boolVec.resize(mTileBound.mMaximum.mCol + day14::helper::sOffByOne, false);
-                        // vector of bool is fcked up...
-                    }
-                }
-                std::cout << "Advancement: " << numberOfAdvancements << '\n';
-                PrintRobots(scratchData, std::cout);
-            }
+            UpdateRobotPositions(scratchData, 1);
+            visitedFields.Clear();
         }
+
+        return {};
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<RobotData> mRobotData;
     TileAABB mTileBound;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
 
 #include <ranges>
 #include <vector>
@@ -23,13 +24,14 @@ class Day15 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day15" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 
 private:
     using Number = int32_t;
     using Position = utility::Position<Number>;
     using Velocity = Position;
     using Direction = utility::Direction;
-    using Wall = Position;
+    using Grid = utility::Grid<day15::helper::FieldType>;
 
     struct Box
     {
@@ -38,10 +40,11 @@ private:
         bool mUpdate;
     };
 
+    // Walls don't move, they are looked up in the map. The second part's map is twice as wide, a column of it is half a column of the map.
     struct ScratchData
     {
         std::vector<Box> mBoxes;
-        std::vector<Wall> mWalls;
+        Number mColumnScale{ 1 };
         Position mRobotPosition;
     };
 
@@ -58,7 +61,7 @@ private:
 
     [[nodiscard]] bool HasWallOnPosition(ScratchData& scratchData, Position position)
     {
-        return std::ranges::any_of(scratchData.mWalls, [=](auto&& wall) {return wall == position; });
+        return mData[Position{ position.mRow, position.mCol / scratchData.mColumnScale }] == day15::helper::sWallField;
     }
 
     [[nodiscard]] bool IsValidInstruction(ScratchData& scratchData, Position positionToMoveFrom, Direction direction)
@@ -114,8 +117,9 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day15, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day15, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         std::vector<std::string_view> splitViews;
         for (auto splitView : mBuffer | std::ranges::views::split("\n\n"sv) | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
         {
@@ -123,21 +127,10 @@ private:
         }
 
         // process map
-        for (auto [rowIndex, rowInput] : splitViews[0] | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }) | std::ranges::views::enumerate)
-        {
-            auto& row{ mData.emplace_back() };
-            row.reserve(rowInput.size());
-            for (const auto [colIndex, field] : rowInput | std::ranges::views::enumerate)
-            {
-                if (field == day15::helper::sRobotField)
-                {
-                    mRobotOrigin = Position{ .mRow = Number(rowIndex), .mCol = Number(colIndex) };
-                }
-
-                row.push_back(field);
-            }
-        }
+        mData = Grid::FromLines(splitViews[0], [](char field) { return field; });
+        const auto robotOrigin{ mData.Find(day15::helper::sRobotField) };
+        assert(robotOrigin);
+        mRobotOrigin = *robotOrigin;
 
         //process instructions
         for (const auto rowInput : splitViews[1] | std::ranges::views::split("\n"sv)
@@ -183,10 +176,21 @@ private:
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mRobotOrigin, mData, mInstructions);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mRobotOrigin, mData, mInstructions);
+    }
+
+    utility::Result PerformFirst() override
     {
         ScratchData scratchData;
-        for (auto [rowIndex, row] : mData | std::ranges::views::enumerate)
+        for (auto [rowIndex, row] : mData.GetRows() | std::ranges::views::enumerate)
         {
             for (auto [colIndex, field] : row | std::ranges::views::enumerate)
             {
@@ -194,10 +198,6 @@ private:
                 {
                     scratchData.mBoxes.emplace_back(Position{ .mRow = static_cast<Number>(rowIndex),.mCol = static_cast<Number>(colIndex) }, Position{ .mRow = static_cast<Number>(rowIndex),.mCol = static_cast<Number>(colIndex) });
                 }
-                else if (field == day15::helper::sWallField)
-                {
-                    scratchData.mWalls.push_back(Position{ .mRow = static_cast<Number>(rowIndex),.mCol = static_cast<Number>(colIndex) });
-                }
             }
         }
         scratchData.mRobotPosition = { .mRow = mRobotOrigin.mRow , .mCol = mRobotOrigin.mCol };
@@ -212,14 +212,14 @@ private:
             result += box.mLeftSide.mRow * 100 + box.mLeftSide.mCol;
         }
 
-        utility::PrintDetails(version, utility::Part::first);
-        utility::PrintResult(result);
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         ScratchData scratchData;
-        for (auto [rowIndex, row] : mData | std::ranges::views::enumerate)
+        scratchData.mColumnScale = 2;
+        for (auto [rowIndex, row] : mData.GetRows() | std::ranges::views::enumerate)
         {
             for (auto [colIndex, field] : row | std::ranges::views::enumerate)
             {
@@ -228,11 +228,6 @@ private:
                 {
                     scratchData.mBoxes.emplace_back(Position{ .mRow = static_cast<Number>(rowIndex),.mCol = newColIndex }, Position{ .mRow = static_cast<Number>(rowIndex),.mCol = newColIndex + 1 });
                 }
-                else if (field == day15::helper::sWallField)
-                {
-                    scratchData.mWalls.push_back(Position{ .mRow = static_cast<Number>(rowIndex),.mCol = newColIndex });
-                    scratchData.mWalls.push_back(Position{ .mRow = static_cast<Number>(rowIndex),.mCol = newColIndex + 1 });
-                }
             }
         }
         scratchData.mRobotPosition = { .mRow = mRobotOrigin.mRow , .mCol = mRobotOrigin.mCol * 2 };
@@ -248,13 +243,13 @@ private:
             result += box.mLeftSide.mRow * 100 + box.mLeftSide.mCol;
         }
 
-        utility::PrintDetails(version, utility::Part::second);
-        utility::PrintResult(result);
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     Position mRobotOrigin;
-    std::vector<std::vector<day15::helper::FieldType>> mData;
+    Grid mData;
     std::vector<Direction> mInstructions;
 };
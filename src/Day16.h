@@ -1,9 +1,12 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
+#include "ThreadPool.h"
 
 #include <ranges>
 #include <vector>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
 #include <mutex>
@@ -15,6 +18,7 @@ class Day16 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day16" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 
 private:
     using Number = int32_t;
@@ -39,75 +43,50 @@ private:
         std::optional<Direction> mDirection;
     };
 
+    using Grid = utility::Grid<FieldType>;
+    using Index = Grid::Index;
+
     struct ScratchData
     {
-        std::vector<std::vector<Node>> mData;
-        std::vector<Position> mNodePositionsPartOfShortestPaths;
+        utility::pmr::Grid<Node> mData;
+        std::pmr::vector<Position> mNodePositionsPartOfShortestPaths;
         Position mStartPosition;
         Position mEndPosition;
     };
 
-    [[nodiscard]] ScratchData CreateScratchData()
+    // The nodes have the same layout as the map, an index into one is an index into the other.
+    [[nodiscard]] ScratchData CreateScratchData(std::pmr::memory_resource* resource)
     {
-        ScratchData scratchData;
+        const auto toNode = [](FieldType type)
+            {
+                return Node{ type, type != FieldType::start ? sMaximumDistance : Number{ 0 } };
+            };
+        ScratchData scratchData{ utility::pmr::Grid<Node>{ mData, toNode, resource }, std::pmr::vector<Position>{ resource } };
         scratchData.mStartPosition = mStartPosition;
         scratchData.mEndPosition = mEndPosition;
 
-        scratchData.mData.reserve(mData.size());
-        for (auto& rowInput : mData)
-        {
-            auto& row{ scratchData.mData.emplace_back() };
-            row.reserve(rowInput.size());
-            for (auto type : rowInput)
-            {
-                if (type != FieldType::start)
-                {
-                    row.emplace_back(type, sMaximumDistance);
-                }
-                else
-                {
-                    row.emplace_back(type, Number{ 0 });
-                }
-            }
-        }
-
         return scratchData;
     }
 
-    // Should be taking it as const, but GetItemAt isn't written properly.
-    [[nodiscard]] Number GetEndDistanceFromStart(/*const */ScratchData& scratchData)
+    [[nodiscard]] Number GetEndDistanceFromStart(const ScratchData& scratchData) const
     {
-        const auto endItemResult{ utility::GetItemAt(scratchData.mData, scratchData.mEndPosition) };
-        if (!endItemResult.has_value())
-        {
-            assert(false);
-            return {};
-        }
-        assert(endItemResult.value());
-        const auto& endNode{ *endItemResult.value() };
-
-        return endNode.mDistance;
+        return scratchData.mData[scratchData.mEndPosition].mDistance;
     }
 
+    // the zone sits here, a zone per recursion of ExploreOptions would bury the trace
     [[nodiscard]] Number GetShortestPathCost(ScratchData& scratchData, Direction direction)
     {
-        ExploreOptions<true>(scratchData, scratchData.mStartPosition, 0, direction);
+        utility::ScopedZone zone{ "ExploreOptions", sDay };
+        ExploreOptions<true>(scratchData, scratchData.mData.GetIndex(scratchData.mStartPosition), 0, direction);
 
         return GetEndDistanceFromStart(scratchData);
     }
 
+    // The map is surrounded by walls, so the walk never needs a bounds check.
     template<bool start = false>
-    void ExploreOptions(ScratchData& scratchData, Position position, Number value, Direction direction)
+    void ExploreOptions(ScratchData& scratchData, Index index, Number value, Direction direction)
     {
-        auto itemAtResult{ utility::GetItemAt(scratchData.mData,position) };
-        if (!itemAtResult.has_value())
-        {
-            assert(false);
-            return;
-        }
-        assert(itemAtResult.value());
-
-        auto& node{ *itemAtResult.value() };
+        auto& node{ scratchData.mData[index] };
         if (node.mType == FieldType::wall)
         {
             return;
@@ -122,29 +101,24 @@ private:
         node.mDirection = direction;
         for (int i = 0; i < 4; i++)
         {
-            ExploreOptions<false>(scratchData, position + utility::GetDirectionValue<Number>(direction), value + (1000 * (i % 2) + 1), direction);
+            ExploreOptions<false>(scratchData, index + scratchData.mData.GetOffset(utility::GetDirectionValue<Number>(direction)), value + (1000 * (i % 2) + 1), direction);
             direction = utility::GetNextDirection(direction);
         }
     }
 
     // Is part of optimal path if distance from start to position + distance from position to end == distance from start to end.
-    bool IsPartOfOptimalPath(/*const*/ ScratchData& scratchData, Position position)
+    bool IsPartOfOptimalPath(const ScratchData& scratchData, Position position)
     {
-        auto itemAtResult{ utility::GetItemAt(scratchData.mData,position) };
-        if (!itemAtResult.has_value())
-        {
-            assert(false);
-            return false;
-        }
-        assert(itemAtResult.value());
-        const auto& node{ *itemAtResult.value() };
+        const auto& node{ scratchData.mData[position] };
 
         if (node.mDistance == sMaximumDistance || !node.mDirection)
         {
             return false;
         }
 
-        ScratchData newScratchData{ CreateScratchData() };
+        // runs on the thread pool, the part's arena isn't thread safe
+        utility::ThreadScratchScope scratchScope;
+        ScratchData newScratchData{ CreateScratchData(scratchScope.GetResource()) };
         newScratchData.mStartPosition = position;
         Number distanceFromPointToEnd{ GetShortestPathCost(newScratchData, *node.mDirection) };
         Number distanceFromOriginalStartToEnd{ GetEndDistanceFromStart(scratchData) };
@@ -154,38 +128,35 @@ private:
 
     void CollectOptimalNodes(ScratchData& scratchData)
     {
-        std::vector<std::thread> workers;
-        std::mutex mutex;
-        for (auto&& [rowIndex, row] : scratchData.mData | std::ranges::views::enumerate)
+        std::pmr::vector<Position> reachedNodePositions{ this->GetScratchResource() };
+        for (auto&& [rowIndex, row] : scratchData.mData.GetRows() | std::ranges::views::enumerate)
         {
-            workers.reserve(row.size());
             for (auto&& [colIndex, node] : row | std::ranges::views::enumerate)
             {
-                if (node.mDistance == sMaximumDistance)
+                if (node.mDistance != sMaximumDistance)
                 {
-                    continue;
+                    reachedNodePositions.push_back({ .mRow = static_cast<Number>(rowIndex), .mCol = static_cast<Number>(colIndex) });
                 }
-
-                Position nodePosition{ .mRow = static_cast<Number>(rowIndex), .mCol = static_cast<Number>(colIndex) };
-                workers.emplace_back([this, nodePosition, &scratchData, &mutex]() {
-                    if (IsPartOfOptimalPath(scratchData, nodePosition))
-                    {
-                        std::unique_lock<std::mutex> lock{ mutex };
-                        scratchData.mNodePositionsPartOfShortestPaths.push_back(nodePosition);
-                        std::cout << "Found item at row: " << nodePosition.mRow << " col: " << nodePosition.mCol << '\n';
-                    }
-                    });
             }
-            std::ranges::for_each(workers, &std::thread::join);
-            workers.clear();
         }
 
+        std::mutex mutex;
+        utility::ParallelFor(0, reachedNodePositions.size(), [this, &reachedNodePositions, &scratchData, &mutex](size_t index)
+            {
+                const auto nodePosition{ reachedNodePositions[index] };
+                if (IsPartOfOptimalPath(scratchData, nodePosition))
+                {
+                    // the lock also keeps the part's arena behind the positions single threaded
+                    std::unique_lock<std::mutex> lock{ mutex };
+                    scratchData.mNodePositionsPartOfShortestPaths.push_back(nodePosition);
+                }
+            });
     }
 
     void PrintPaths(ScratchData& scratchData)
     {
         std::cout << '\n';
-        for (auto [rowIndex, row] : scratchData.mData | std::ranges::views::enumerate)
+        for (auto [rowIndex, row] : scratchData.mData.GetRows() | std::ranges::views::enumerate)
         {
             for (auto [colIndex, node] : row | std::ranges::views::enumerate)
             {
@@ -228,70 +199,62 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day16, version> inputReader;
-        mBuffer = inputReader.Read();
-        std::vector<std::string_view> splitViews;
-        for (auto rowInput : mBuffer | std::ranges::views::split("\n"sv) | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
-        {
-            auto& row{ mData.emplace_back() };
-            row.reserve(rowInput.size());
-            for (auto [colIndex, character] : rowInput | std::ranges::views::enumerate)
+        utility::InputReader<Day16, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mData = Grid::FromLines(mBuffer, [](char character)
             {
                 switch (character)
                 {
-                case '.':
-                {
-                    row.emplace_back(FieldType::empty);
-                }
-                break;
                 case '#':
-                {
-                    row.emplace_back(FieldType::wall);
-                }
-                break;
+                    return FieldType::wall;
                 case 'S':
-                {
-                    row.emplace_back(FieldType::start);
-                    mStartPosition = Position{ .mRow = static_cast<Number>(mData.size()) - 1, .mCol = static_cast<Number>(colIndex) };
-                }
-                break;
+                    return FieldType::start;
                 case 'E':
-                {
-                    row.emplace_back(FieldType::end);
-                    mEndPosition = Position{ .mRow = static_cast<Number>(mData.size()) - 1, .mCol = static_cast<Number>(colIndex) };
-                }
-                break;
-                case '\0':
-                {
-                    return;
-                }break;
+                    return FieldType::end;
+                default:
+                    return FieldType::empty;
                 }
-            }
-        }
+            });
+
+        const auto startPosition{ mData.Find(FieldType::start) };
+        const auto endPosition{ mData.Find(FieldType::end) };
+        assert(startPosition && endPosition);
+        mStartPosition = *startPosition;
+        mEndPosition = *endPosition;
+    }
+
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData, mStartPosition, mEndPosition);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData, mStartPosition, mEndPosition);
     }
 
-    void PerformFirst() override
+    utility::Result PerformFirst() override
     {
-        utility::PrintDetails(version, utility::Part::first);
-        auto scratchData{ CreateScratchData() };
+        auto scratchData{ CreateScratchData(this->GetScratchResource()) };
         Number result{ GetShortestPathCost(scratchData, Direction::right) };
-        utility::PrintResult(result);
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
-        utility::PrintDetails(version, utility::Part::second);
-        auto scratchData{ CreateScratchData() };
+        auto scratchData{ CreateScratchData(this->GetScratchResource()) };
         std::ignore = GetShortestPathCost(scratchData, Direction::right);
         CollectOptimalNodes(scratchData);
         Number result{ static_cast<Number>(scratchData.mNodePositionsPartOfShortestPaths.size()) };
-        utility::PrintResult(result);
-        PrintPaths(scratchData);
+        return result;
     }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<FieldType>> mData;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    Grid mData;
     Position mStartPosition;
     Position mEndPosition;
 };
@@ -93,44 +93,68 @@ class Day2 : public DayBase<version>
 {
 public:
     static constexpr std::string_view sDay{ "day2" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
 
+    void ReadLine(std::string_view numbersInString)
+    {
+        using namespace std::literals;
+        auto& report{ mReports.emplace_back() };
+        for (const auto value : numbersInString | std::ranges::views::split(" "sv)
+            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; })
+            )
+        {
+            report.push_back(utility::ToNumber(value));
+        }
+    }
+
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day2, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day2, version> inputReader{ this->GetInputSource() };
+        if (this->GetInputSource().mIsStreaming)
+        {
+            inputReader.ForEachRecord("\n", [this](std::string_view line) { ReadLine(line); });
+            return;
+        }
+
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         for (const auto numbersInString : mBuffer | std::ranges::views::split("\n"sv)
             | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
         {
-            auto& report{ mReports.emplace_back() };
-            for (const auto value : numbersInString | std::ranges::views::split(" "sv)
-                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; })
-                )
-            {
-                report.push_back(utility::ToNumber(value));
-            }
+            ReadLine(numbersInString);
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mReports);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mReports);
+    }
+
+    utility::Result PerformFirst() override
     {
         const int32_t result{ static_cast<int32_t>(std::ranges::count_if(mReports,
             [this](std::span<int32_t> report) { return day2::helper::Validate(report); })) };
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         const int32_t result{ static_cast<int32_t>(std::ranges::count_if(mReports,
             [this](std::span<int32_t> report) { return day2::helper::Validate(report, day2::helper::Dampener{}); })) };
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << "\n";
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<std::vector<int32_t>> mReports;
 };
@@ -2,7 +2,9 @@
 
 #include "Utility.h"
 #include "Day.h"
+#include <array>
 #include <regex>
+#include <span>
 
 template<utility::InputVersion version = utility::InputVersion::release>
 class Day3 : public DayBase<version>
@@ -19,24 +21,18 @@ public:
 
 private:
 
-    void StoreMatch(const std::regex_token_iterator<std::string::iterator>& match, Instruction instruction)
+    void StoreMatch(const std::regex_token_iterator<std::string_view::const_iterator>& match, Instruction instruction)
     {
         mMatches.push_back({ std::string_view{ match->first, match->second }, instruction });
     }
 
-    int32_t MultiplyNumbers(std::vector<int32_t> numbers)
+    // a mul match holds exactly two numbers
+    int32_t MultiplyNumbers(std::string_view match)
     {
-        if (numbers.empty())
-        {
-            return {};
-        }
-
-        int32_t result{ 1 };
-        for (const auto number : numbers)
-        {
-            result *= number;
-        }
-        return result;
+        std::array<int32_t, 2> numbers{};
+        [[maybe_unused]] const auto count{ utility::ScanNumbers(match, std::span{ numbers }) };
+        assert(count == numbers.size());
+        return numbers[0] * numbers[1];
     }
 
     void GetInstruction(Instruction type)
@@ -61,8 +57,8 @@ private:
             baseRegex = std::regex{ sMatchMulExpression.data() };
         }break;
         }
-        std::regex_token_iterator<std::string::iterator> endSentinelIterator;
-        std::regex_token_iterator<std::string::iterator> matchIterator{ mBuffer.begin(), mBuffer.end(), baseRegex };
+        std::regex_token_iterator<std::string_view::const_iterator> endSentinelIterator;
+        std::regex_token_iterator<std::string_view::const_iterator> matchIterator{ mBuffer.begin(), mBuffer.end(), baseRegex };
         while (matchIterator != endSentinelIterator)
         {
             StoreMatch(matchIterator++, type);
@@ -72,29 +68,29 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day3, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day3, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         GetInstruction(Instruction::mul);
         GetInstruction(Instruction::enable);
         GetInstruction(Instruction::disable);
         std::ranges::sort(mMatches, [](const auto& pair1, const auto& pair2) {return pair1.first.data() < pair2.first.data(); });
     }
 
-    void PerformFirst() override
+    utility::Result PerformFirst() override
     {
         int32_t result{};
         for (const auto [match, instructionType] : mMatches)
         {
             if (instructionType == Instruction::mul)
             {
-                result += MultiplyNumbers(utility::GetNumbers(match));
+                result += MultiplyNumbers(match);
             }
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << "\n";
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         bool enabled{ true };
         int32_t result{};
@@ -114,16 +110,16 @@ private:
             {
                 if (enabled)
                 {
-                    result += MultiplyNumbers(utility::GetNumbers(match));
+                    result += MultiplyNumbers(match);
                 }
             } break;
             }
         }
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<std::pair<std::string_view, Instruction>> mMatches;
 };
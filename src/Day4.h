@@ -1,50 +1,26 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
 
 #include <ranges>
-#include <unordered_map>
 #include <array>
 
-namespace day4::helper
-{
-    enum class Direction
-    {
-        left,
-        right,
-        up,
-        down,
-        leftUp,
-        leftDown,
-        rightUp,
-        rightDown,
-    };
-}
-
 template<utility::InputVersion version = utility::InputVersion::release>
 class Day4 : public DayBase<version>
 {
 public:
 
     static constexpr std::string_view sDay{ "day4" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 private:
     using FieldType = char;
-    using DirectionData = std::pair<int32_t, int32_t>;
-    using Direction = day4::helper::Direction;
-
-    const std::unordered_map<Direction, DirectionData> mDirectionsMap
-    {
-        {Direction::left,   {0,-1} },
-        {Direction::right,  {0,1}},
-        {Direction::up,     {-1, 0}},
-        {Direction::down,   {1, 0}},
-        {Direction::leftUp, {-1,-1}},
-        {Direction::leftDown,{1,-1}},
-        {Direction::rightDown, {1, 1}},
-        {Direction::rightUp, {-1,1}},
-    };
+    using Grid = utility::Grid<FieldType>;
+    using Index = Grid::Index;
+    using Direction = utility::Direction;
 
     static constexpr std::array<FieldType, 4> sCharacterOrder{ 'X', 'M', 'A', 'S' };
+    static constexpr FieldType sBorderField{ '.' };
 
     static constexpr int32_t GetCharacterIndex(FieldType character)
     {
@@ -73,74 +49,60 @@ private:
     static_assert(GetNextCharacter('A') == 'S');
     static_assert(GetNextCharacter('S') == 'X');
 
-    int32_t GetNumberOfMatches(int32_t row, int32_t col, FieldType expectedCharacter = 'X', FieldType endCharacter = 'S')
+    [[nodiscard]] Index GetOffset(Direction direction) const
     {
-        if (row >= mData.size() || col >= mData[row].size())
-        {
-            return 0;
-        }
+        return mData.GetOffset(utility::GetDirectionData(direction));
+    }
 
-        FieldType currentCharacter{ mData[row][col] };
-        if (expectedCharacter != currentCharacter)
+    int32_t GetNumberOfMatches(Index index, FieldType expectedCharacter = 'X', FieldType endCharacter = 'S')
+    {
+        if (expectedCharacter != mData[index])
         {
             return 0;
         }
 
         const auto nextExpectedCharacter{ GetNextCharacter(expectedCharacter) };
         int32_t result{};
-        for (const auto change : mDirectionsMap)
-        {
-            const auto direction{ change.first };
-            const auto [verticalChange, horizontalChange] {change.second};
-            if (GetMatch(row + verticalChange, col + horizontalChange, direction, nextExpectedCharacter, endCharacter))
+        utility::ForEachNeighbor<utility::sFullDirections>(index, mData.GetStride(), [&](Direction, Index neighbour)
             {
-                ++result;
-            }
-        }
+                if (GetMatch(neighbour, neighbour - index, nextExpectedCharacter, endCharacter))
+                {
+                    ++result;
+                }
+            });
 
         return result;
     }
 
-    bool GetMatch(int32_t row, int32_t col, Direction direction, FieldType expectedCharacter = 'X', FieldType endCharacter = 'S')
+    // No bounds check, a walk off the map ends on the border, which matches no character.
+    bool GetMatch(Index index, Index offset, FieldType expectedCharacter = 'X', FieldType endCharacter = 'S')
     {
-        // Bounds check
-        if (row >= mData.size() || col >= mData[row].size())
-        {
-            return 0;
-        }
-
-        FieldType currentCharacter{ mData[row][col] };
-        if (expectedCharacter != currentCharacter)
+        if (expectedCharacter != mData[index])
         {
-            return 0;
+            return false;
         }
 
         if (expectedCharacter == endCharacter)
         {
-            return 1;
+            return true;
         }
 
-        FieldType nextExpectedCharacter{ GetNextCharacter(expectedCharacter) };
-        const auto& [verticalChange, horizontalChange] { mDirectionsMap.at(direction) };
-        return GetMatch(row + verticalChange, col + horizontalChange, direction, nextExpectedCharacter, endCharacter);
+        return GetMatch(index + offset, offset, GetNextCharacter(expectedCharacter), endCharacter);
     }
 
-    bool GetDiagonalMatch(int32_t row, int32_t col, Direction direction, FieldType character, FieldType otherCharacter)
+    bool GetDiagonalMatch(Index index, Direction direction, FieldType character, FieldType otherCharacter)
     {
-        const auto [directionVertical, directionHorizontal] {mDirectionsMap.at(direction)};
-        const auto flippedVertical = -directionVertical;
-        const auto flippedHorizontal = -directionHorizontal;
-
-        if (GetMatch(row + directionVertical, col + directionHorizontal, direction, character, character))
+        const auto offset{ GetOffset(direction) };
+        if (GetMatch(index + offset, offset, character, character))
         {
-            if (GetMatch(row + flippedVertical, col + flippedHorizontal, direction, otherCharacter, otherCharacter))
+            if (GetMatch(index - offset, offset, otherCharacter, otherCharacter))
             {
                 return true;
             }
         }
-        else if (GetMatch(row + directionVertical, col + directionHorizontal, direction, otherCharacter, otherCharacter))
+        else if (GetMatch(index + offset, offset, otherCharacter, otherCharacter))
         {
-            if (GetMatch(row + flippedVertical, col + flippedHorizontal, direction, character, character))
+            if (GetMatch(index - offset, offset, character, character))
             {
                 return true;
             }
@@ -149,25 +111,19 @@ private:
         return false;
     }
 
-    int32_t GetNumberOfDiagonalMatches(int32_t row, int32_t col, FieldType expectedCharacter = 'A')
+    int32_t GetNumberOfDiagonalMatches(Index index, FieldType expectedCharacter = 'A')
     {
-        if (row >= mData.size() || col >= mData[row].size())
-        {
-            return 0;
-        }
-
-        FieldType currentCharacter{ mData[row][col] };
-        if (expectedCharacter != currentCharacter)
+        if (expectedCharacter != mData[index])
         {
             return 0;
         }
 
         int32_t result{};
-        if (GetDiagonalMatch(row, col, Direction::leftUp, 'M', 'S'))
+        if (GetDiagonalMatch(index, Direction::leftUp, 'M', 'S'))
         {
             ++result;
         }
-        if (GetDiagonalMatch(row, col, Direction::leftDown, 'M', 'S'))
+        if (GetDiagonalMatch(index, Direction::leftDown, 'M', 'S'))
         {
             ++result;
         }
@@ -177,53 +133,54 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day4, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
-        {
-            const auto rowSize{ rowInput.size() };
-            auto& row{ mData.emplace_back() };
-            row.reserve(rowSize);
-            for (char character : rowInput)
-            {
-                row.emplace_back(character);
-            }
-        }
+        utility::InputReader<Day4, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mData = Grid::FromLines(mBuffer, [](char character) { return character; }, 1, sBorderField);
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData);
+    }
+
+    utility::Result PerformFirst() override
     {
         int32_t result{};
-        for (const auto [rowIndex, row] : mData | std::ranges::views::enumerate)
+        for (int32_t rowIndex = 0; rowIndex < mData.GetRowCount(); rowIndex++)
         {
-            for (const auto [colIndex, col] : row | std::ranges::views::enumerate)
+            for (int32_t colIndex = 0; colIndex < mData.GetColumnCount(); colIndex++)
             {
-                result += GetNumberOfMatches(rowIndex, colIndex, sCharacterOrder.front(), sCharacterOrder.back());
+                result += GetNumberOfMatches(mData.GetIndex({ rowIndex, colIndex }), sCharacterOrder.front(), sCharacterOrder.back());
             }
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         int32_t result{};
-        for (const auto [rowIndex, row] : mData | std::ranges::views::enumerate)
+        for (int32_t rowIndex = 0; rowIndex < mData.GetRowCount(); rowIndex++)
         {
-            for (const auto [colIndex, col] : row | std::ranges::views::enumerate)
+            for (int32_t colIndex = 0; colIndex < mData.GetColumnCount(); colIndex++)
             {
-                if (2 == GetNumberOfDiagonalMatches(rowIndex, colIndex))
+                if (2 == GetNumberOfDiagonalMatches(mData.GetIndex({ rowIndex, colIndex })))
                 {
                     ++result;
                 }
             }
         }
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<FieldType>> mData;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    Grid mData;
 };
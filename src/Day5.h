@@ -2,6 +2,7 @@
 #include "Utility.h"
 #include "Day.h"
 
+#include <array>
 #include <unordered_map>
 #include <vector>
 #include <span>
@@ -14,6 +15,7 @@ class Day5 : public DayBase<version>
 public:
 
     static constexpr std::string_view sDay{ "day5" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 private:
     using PageNumber = int32_t;
 
@@ -103,16 +105,15 @@ private:
         {
             FixOrderingOfElement(range, invalidElements.front());
         }
-
-        mFixedUpdates.push_back(range);
     }
 
 
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day5, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day5, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         bool updatesNext{ false };
         for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
             | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
@@ -123,24 +124,36 @@ private:
                 continue;
             }
 
-            std::vector<PageNumber> numbers{ utility::GetNumbers(rowInput) };
-            assert(!numbers.empty());
-
             // Ordering
             if (!updatesNext)
             {
+                std::array<PageNumber, 2> numbers{};
+                [[maybe_unused]] const auto count{ utility::ScanNumbers(rowInput, std::span{ numbers }) };
+                assert(count == numbers.size());
                 const auto [iterator, _] {mOriginalOrdering.try_emplace(numbers.front())};
                 // no need to check if inserted, we only care about the vector being there, which is guaranteed.
                 iterator->second.push_back(numbers.back());
             }
             else
             {
-                mUpdates.push_back(std::move(numbers));
+                mUpdates.push_back(utility::GetNumbers<PageNumber>(rowInput));
+                assert(!mUpdates.back().empty());
             }
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mOriginalOrdering, mUpdates);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mOriginalOrdering, mUpdates);
+    }
+
+    utility::Result PerformFirst() override
     {
         PageNumber result{};
         for (const auto& update : mUpdates)
@@ -151,33 +164,29 @@ private:
                 result += update[middleElementIndex];
             }
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
+        // fixes copies, the parsed updates are shared with the first part
         PageNumber result{};
-        for (auto& update : mUpdates)
+        for (const auto& update : mUpdates)
         {
             if (!SatisfiesOrderingRequirements(update))
             {
-                FixOrdering(update);
+                auto fixedUpdate{ update };
+                FixOrdering(fixedUpdate);
+                const auto middleElementIndex{ fixedUpdate.size() / 2 };
+                result += fixedUpdate[middleElementIndex];
             }
         }
-
-        for (const auto& fixedOrder : mFixedUpdates)
-        {
-            const auto middleElementIndex{ fixedOrder.size() / 2 };
-            result += fixedOrder[middleElementIndex];
-        }
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::unordered_map<PageNumber, std::vector<PageNumber>> mOriginalOrdering;
     std::vector<std::vector<PageNumber>> mUpdates;
-    std::vector<std::vector<PageNumber>> mFixedUpdates;
 };
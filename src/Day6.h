@@ -1,11 +1,14 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
+#include "ThreadPool.h"
 
 #include <iostream>
 #include <ranges>
 #include <expected>
 #include <optional>
+#include <memory_resource>
 
 template<utility::InputVersion version = utility::InputVersion::release>
 class Day6 : public DayBase<version>
@@ -23,8 +26,12 @@ class Day6 : public DayBase<version>
         empty,
         guardStart,
         wall,
+        outside,    // the border around the map
     };
 
+    using Grid = utility::Grid<FieldType>;
+    using Index = Grid::Index;
+
     struct Position
     {
         using PositionType = int32_t;
@@ -104,7 +111,7 @@ class Day6 : public DayBase<version>
         }
 
         Position mPosition{};
-        std::vector<Direction> mDirectionsApproachedFrom;
+        std::pmr::vector<Direction> mDirectionsApproachedFrom;
         FieldType mType{ FieldType::empty };
     };
 
@@ -114,14 +121,17 @@ class Day6 : public DayBase<version>
         wallVisitedMultipleTimes,
     };
 
+    // Everything is allocated from one resource, a part's arena or the one of a thread pool task.
     struct ScratchData
     {
+        explicit ScratchData(std::pmr::memory_resource* resource) : mVisitedFields{ resource }, mVisitedWalls{ resource }, mFieldOverrides{ resource } {}
+
         Field& MarkFieldAsVisited(Position position, FieldType type, Direction direction)
         {
             const auto resultIterator{ std::ranges::find_if(mVisitedFields,[position](const auto& field) {return field == position; }) };
             if (resultIterator == mVisitedFields.end())
             {
-                mVisitedFields.emplace_back(position, std::vector<Direction>{direction}, type);
+                mVisitedFields.emplace_back(position, std::pmr::vector<Direction>{ { direction }, mVisitedFields.get_allocator() }, type);
                 return mVisitedFields.back();
             }
 
@@ -137,7 +147,7 @@ class Day6 : public DayBase<version>
             const auto resultIterator{ std::ranges::find_if(mVisitedWalls,[position](const auto& field) {return field == position; }) };
             if (resultIterator == mVisitedWalls.end())
             {
-                mVisitedWalls.emplace_back(position, std::vector<Direction>{direction}, type);
+                mVisitedWalls.emplace_back(position, std::pmr::vector<Direction>{ { direction }, mVisitedWalls.get_allocator() }, type);
                 return mVisitedFields.back();
             }
 
@@ -156,10 +166,10 @@ class Day6 : public DayBase<version>
             return {};
         }
 
-        std::vector<Field> mVisitedFields;
-        std::vector<Field> mVisitedWalls;
+        std::pmr::vector<Field> mVisitedFields;
+        std::pmr::vector<Field> mVisitedWalls;
 
-        std::vector<Field> mFieldOverrides;
+        std::pmr::vector<Field> mFieldOverrides;
     };
 
     static constexpr std::array<Direction, 4> sDirectionOrder{ Direction::up, Direction::right, Direction::down, Direction::left };
@@ -169,27 +179,25 @@ class Day6 : public DayBase<version>
         Position{.mRow = 1, .mCol = 0},
         Position{.mRow = 0, .mCol = -1} };
 
-    template<utility::IsMultiDimensionalRandomAccessRange T>
-    struct TwoDimensionalVectorType
+    [[nodiscard]] Index GetIndex(Position position) const
     {
-        using type = std::remove_cvref_t<std::remove_pointer_t<std::ranges::range_value_t<std::remove_cvref_t<std::remove_pointer_t<std::ranges::range_value_t<T>>>>>>;
-        using pointer_type = type*;
-    };
+        return mData.GetIndex({ position.mRow, position.mCol });
+    }
 
-    template<utility::IsMultiDimensionalRandomAccessRange T>
-    std::expected<typename TwoDimensionalVectorType<T>::pointer_type, ErrorType> GetItemAt(T&& vector, Position position)
+public:
+    static constexpr std::string_view sDay{ "day6" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
+
+    [[nodiscard]] static std::vector<utility::Strategy<Day6>> GetStrategies(utility::Part part)
     {
-        if (position.mRow < 0 || position.mRow >= vector.size() || position.mCol < 0 || position.mCol >= vector[position.mRow].size())
+        if (part == utility::Part::second)
         {
-            return std::unexpected{ ErrorType::outOfBounds };
+            return { { "reference", &Day6::PerformSecond }, { "route", &Day6::PerformSecondOnRoute } };
         }
 
-        return &vector[position.mRow][position.mCol];
+        return {};
     }
 
-public:
-    static constexpr std::string_view sDay{ "day6" };
-
 private:
     static constexpr size_t GetDirectionIndex(Direction direction)
     {
@@ -231,34 +239,25 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day6, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
-        {
-            mData.emplace_back(rowInput.size(), FieldType::empty);
-            auto& row{ mData.back() };
-            for (const auto [index, character] : rowInput | std::ranges::views::enumerate)
+        utility::InputReader<Day6, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mData = Grid::FromLines(mBuffer, [](char character)
             {
-                if (character == '\0')
+                switch (character)
                 {
-                    break;
+                case '#':
+                    return FieldType::wall;
+                case '^':
+                    return FieldType::guardStart;
+                default:
+                    return FieldType::empty;
                 }
+            }, 1, FieldType::outside);
 
-                if (character == '#')
-                {
-                    row[index] = FieldType::wall;
-                    continue;
-                }
-
-                if (character == '^')
-                {
-                    row[index] = FieldType::guardStart;
-                    mGuardOrigin.mRow = mData.size() - 1;
-                    mGuardOrigin.mCol = index;
-                }
-            }
-        }
+        const auto guardOrigin{ mData.Find(FieldType::guardStart) };
+        assert(guardOrigin);
+        mGuardOrigin = { .mRow = guardOrigin->mRow, .mCol = guardOrigin->mCol };
     };
 
     // If a Field with FieldType is found, it returns the position of the that field.
@@ -267,14 +266,12 @@ private:
     {
         assert(scratchData);
 
-        const auto itemResult{ GetItemAt(mData, position) };
-        if (!itemResult.has_value())
+        auto itemResultType{ mData[GetIndex(position)] };
+        if (itemResultType == FieldType::outside)
         {
-            return std::unexpected{ itemResult.error() };
+            return std::unexpected{ ErrorType::outOfBounds };
         }
 
-        assert(itemResult.value());
-        auto itemResultType{ *itemResult.value() };
         if (auto optionalFieldOverride{ scratchData->TryGetFieldOverride(position) })
         {
             itemResultType = optionalFieldOverride->mType;
@@ -302,12 +299,23 @@ private:
         return FindNextFieldTypeInDirection(position, direction, scratchData, typeToSearchFor);
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData, mGuardOrigin);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData, mGuardOrigin);
+    }
+
+    utility::Result PerformFirst() override
     {
         int32_t result{};
         Position guardPosition{ mGuardOrigin };
         Direction guardDirection{ Direction::up };
-        ScratchData scratchData;
+        ScratchData scratchData{ this->GetScratchResource() };
         while (true)
         {
             const auto searchResult{ FindNextFieldTypeInDirection(guardPosition, guardDirection, &scratchData) };
@@ -333,27 +341,25 @@ private:
         }
         result = scratchData.mVisitedFields.size();
 
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     };
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         std::atomic_int32_t result{};
-        std::vector<std::thread> workers;
-
-        for (int32_t rowIndex = 0; rowIndex < mData.size(); rowIndex++)
-        {
-            const auto task = [this, rowIndex, &result]
+        utility::ParallelFor(0, mData.GetRowCount(), [this, &result](size_t row)
                 {
+                    const auto rowIndex{ static_cast<int32_t>(row) };
                     int32_t taskResult{};
-                    for (const auto [columnIndex, fieldType] : mData[rowIndex] | std::ranges::views::enumerate
+                    for (const auto [columnIndex, fieldType] : mData.GetRow(rowIndex) | std::ranges::views::enumerate
                         | std::ranges::views::filter([](const auto& indexValuePair) { return std::get<1>(indexValuePair) == FieldType::empty; }))
                     {
                         Position guardPosition{ mGuardOrigin };
                         Direction guardDirection{ Direction::up };
-                        ScratchData scratchData;
-                        scratchData.mFieldOverrides.emplace_back(Position{ .mRow = rowIndex, .mCol = static_cast<Position::PositionType>(columnIndex) }, std::vector<Direction>{}, FieldType::wall);
+                        // released after every simulated obstacle, the part's arena isn't thread safe
+                        utility::ThreadScratchScope scratchScope;
+                        ScratchData scratchData{ scratchScope.GetResource() };
+                        scratchData.mFieldOverrides.emplace_back(Position{ .mRow = rowIndex, .mCol = static_cast<Position::PositionType>(columnIndex) }, std::pmr::vector<Direction>{ scratchScope.GetResource() }, FieldType::wall);
 
                         while (true)
                         {
@@ -366,7 +372,7 @@ private:
                                 }
                                 if (searchResult.error() == ErrorType::wallVisitedMultipleTimes)
                                 {
-                                    result++;
+                                    taskResult++;
                                     break;
                                 }
                             }
@@ -381,22 +387,114 @@ private:
                         }
                     }
                     result.fetch_add(taskResult, std::memory_order_relaxed);
-                };
+                }, 1);
+
+        return result.load(std::memory_order_acquire);
+    };
+
+    // An obstacle off the guard's route doesn't change it, so only the cells of the route are tried. The guard walks the same
+    // up to the first time it enters the obstacle's cell, each try starts right in front of it. A loop shows as a turn
+    // that was taken before at the same cell in the same direction, those are kept as bits per cell.
+    struct ObstacleCandidate
+    {
+        Index mObstacle;
+        Index mGuardIndex;
+        size_t mDirectionIndex;
+    };
+
+    using DirectionOffsets = std::array<Index, 4>;
+
+    [[nodiscard]] DirectionOffsets GetDirectionOffsets() const
+    {
+        DirectionOffsets result{};
+        for (const auto [offset, directionValue] : std::ranges::views::zip(result, sDirectionValuesInOrder))
+        {
+            offset = mData.GetOffset({ directionValue.mRow, directionValue.mCol });
+        }
+        return result;
+    }
+
+    // The guard walks on linear indices, leaving the map shows as a step onto the border.
+    [[nodiscard]] bool IsLoopWithObstacle(const ObstacleCandidate& candidate, const DirectionOffsets& directionOffsets, std::pmr::memory_resource* resource) const
+    {
+        std::pmr::vector<uint8_t> turnDirections(mData.GetCells().size(), 0, resource);
+        Index guardIndex{ candidate.mGuardIndex };
+        size_t directionIndex{ candidate.mDirectionIndex };
+        while (true)
+        {
+            const auto nextIndex{ guardIndex + directionOffsets[directionIndex] };
+            const auto nextField{ mData[nextIndex] };
+            if (nextField == FieldType::outside)
+            {
+                return false;
+            }
 
-            workers.emplace_back(task);
+            if (nextIndex == candidate.mObstacle || nextField == FieldType::wall)
+            {
+                auto& turns{ turnDirections[guardIndex] };
+                const uint8_t directionBit(1 << directionIndex);
+                if (turns & directionBit)
+                {
+                    return true;
+                }
+
+                turns |= directionBit;
+                directionIndex = (directionIndex + 1) % sDirectionOrder.size();
+                continue;
+            }
+
+            guardIndex = nextIndex;
         }
+    }
 
-        for (auto& worker : workers)
+    utility::Result PerformSecondOnRoute()
+    {
+        const auto directionOffsets{ GetDirectionOffsets() };
+        const auto guardOrigin{ GetIndex(mGuardOrigin) };
+        std::pmr::vector<bool> isOnRoute(mData.GetCells().size(), false, this->GetScratchResource());
+        std::pmr::vector<ObstacleCandidate> candidates{ this->GetScratchResource() };
+
+        Index guardIndex{ guardOrigin };
+        size_t directionIndex{ GetDirectionIndex(Direction::up) };
+        while (true)
         {
-            worker.join();
+            const auto nextIndex{ guardIndex + directionOffsets[directionIndex] };
+            const auto nextField{ mData[nextIndex] };
+            if (nextField == FieldType::outside)
+            {
+                break;
+            }
+
+            if (nextField == FieldType::wall)
+            {
+                directionIndex = (directionIndex + 1) % sDirectionOrder.size();
+                continue;
+            }
+
+            if (!isOnRoute[nextIndex] && nextIndex != guardOrigin)
+            {
+                isOnRoute[nextIndex] = true;
+                candidates.emplace_back(nextIndex, guardIndex, directionIndex);
+            }
+            guardIndex = nextIndex;
         }
 
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result.load(std::memory_order_acquire) << '\n';
-    };
+        std::atomic_int32_t result{};
+        utility::ParallelFor(0, candidates.size(), [this, &candidates, &result, &directionOffsets](size_t candidateIndex)
+            {
+                utility::ThreadScratchScope scratchScope;
+                if (IsLoopWithObstacle(candidates[candidateIndex], directionOffsets, scratchScope.GetResource()))
+                {
+                    result.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+
+        return result.load(std::memory_order_acquire);
+    }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<FieldType>> mData;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    Grid mData;
     Position mGuardOrigin{};
 };
@@ -1,9 +1,11 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "ThreadPool.h"
 
 #include <ranges>
 #include <vector>
+#include <memory_resource>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -14,13 +16,15 @@ class Day7 : public DayBase<version>
 
 public:
     static constexpr std::string_view sDay{ "day7" };
+    static constexpr uint32_t sParseCacheVersion{ 1 };
 
 private:
     using IntegralFunctionOperator = std::function<Number(Number, Number)>;
     using IntegralFunctionOperatorsResult = std::vector<std::vector<IntegralFunctionOperator>>;
+    // The map lives in the part's arena, the lock keeps the tasks filling it from using the arena at the same time.
     struct ScratchData
     {
-        std::unordered_map<Number, IntegralFunctionOperatorsResult> mResults;
+        std::pmr::unordered_map<Number, IntegralFunctionOperatorsResult> mResults;
         std::mutex mResultMapLock;
     };
 
@@ -90,29 +94,52 @@ private:
         return false;
     }
 
+    void ReadLine(std::string_view rowInput)
+    {
+        mData.push_back(utility::GetNumbers<Number>(rowInput));
+        assert(mData.back().size() > 2);
+        mNumberofOperandsNeeded.emplace(static_cast<Number>(mData.back().size() - 2));
+    }
+
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day7, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+        utility::InputReader<Day7, version> inputReader{ this->GetInputSource() };
+        if (this->GetInputSource().mIsStreaming)
+        {
+            inputReader.ForEachRecord("\n", [this](std::string_view line) { ReadLine(line); });
+        }
+        else
         {
-            mData.push_back(utility::GetNumbers<Number>(rowInput));
-            assert(mData.back().size() > 2);
-            mNumberofOperandsNeeded.emplace(static_cast<Number>(mData.back().size() - 2));
+            mInput = inputReader.Map();
+            mBuffer = mInput.GetView();
+            for (const auto rowInput : mBuffer | std::ranges::views::split("\n"sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+            {
+                ReadLine(rowInput);
+            }
         }
 
         assert(utility::Concatenate(10, 24) == 1024);
         assert(utility::Concatenate(2, 2000) == 22000);
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData, mNumberofOperandsNeeded);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData, mNumberofOperandsNeeded);
+    }
+
+    utility::Result PerformFirst() override
     {
         // Calculate all the different permutations of operands
-        std::vector<std::thread> workers;
-        workers.reserve(mNumberofOperandsNeeded.size());
-        ScratchData scratchData;
+        utility::TaskGroup taskGroup;
+        ScratchData scratchData{ std::pmr::unordered_map<Number, IntegralFunctionOperatorsResult>{ this->GetScratchResource() } };
         for (const auto numberOfOperands : mNumberofOperandsNeeded)
         {
             const auto task = [this, &scratchData, numberOfOperands]()
@@ -122,9 +149,9 @@ private:
                     std::unique_lock<std::mutex> guard{ scratchData.mResultMapLock };
                     scratchData.mResults.emplace(numberOfOperands, std::move(result));
                 };
-            workers.emplace_back(task);
+            taskGroup.Run(task);
         }
-        std::ranges::for_each(workers, &std::thread::join);
+        taskGroup.Wait();
 
         Number result{};
         for (auto& row : mData)
@@ -136,15 +163,13 @@ private:
                 result += desiredNumber;
             }
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
-        std::vector<std::thread> workers;
-        workers.reserve(mNumberofOperandsNeeded.size());
-        ScratchData scratchData;
+        utility::TaskGroup taskGroup;
+        ScratchData scratchData{ std::pmr::unordered_map<Number, IntegralFunctionOperatorsResult>{ this->GetScratchResource() } };
         for (const auto numberOfOperands : mNumberofOperandsNeeded)
         {
             const auto task = [this, &scratchData, numberOfOperands]()
@@ -155,9 +180,9 @@ private:
                     std::unique_lock<std::mutex> guard{ scratchData.mResultMapLock };
                     scratchData.mResults.emplace(numberOfOperands, std::move(result));
                 };
-            workers.emplace_back(task);
+            taskGroup.Run(task);
         }
-        std::ranges::for_each(workers, &std::thread::join);
+        taskGroup.Wait();
 
         Number result{};
         for (auto& row : mData)
@@ -169,12 +194,12 @@ private:
                 result += desiredNumber;
             }
         }
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<std::vector<Number>> mData;
     std::unordered_set<Number> mNumberofOperandsNeeded;
 };
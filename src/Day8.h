@@ -1,6 +1,7 @@
 #pragma once
 #include "Utility.h"
 #include "Day.h"
+#include "Grid.h"
 
 #include <ranges>
 #include <vector>
@@ -27,6 +28,7 @@ class Day8 : public DayBase<version>
 
 public:
     static constexpr std::string_view sDay{ "day8" };
+    static constexpr uint32_t sParseCacheVersion{ 2 };
 
 private:
 
@@ -93,37 +95,24 @@ private:
 
     bool IsPositionInBounds(Position position)
     {
-        if (position.mRow < 0 || position.mRow >= mData.size() || position.mCol < 0 || position.mCol >= mData[position.mRow].size())
-        {
-            return false;
-        }
-
-        return true;
+        return mData.IsInside(position);
     }
 
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day8, version> inputReader;
-        mBuffer = inputReader.Read();
-        for (const auto [index, rowInput] : mBuffer | std::ranges::views::split("\n"sv)
-            | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }) | std::ranges::views::enumerate)
+        utility::InputReader<Day8, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
+        mData = utility::Grid<Field>::FromLines(mBuffer, [](char character) { return character; });
+        for (const auto [index, row] : mData.GetRows() | std::ranges::views::enumerate)
         {
-            mData.emplace_back();
-            auto& row{ mData.back() };
-            row.reserve(rowInput.size());
-            for (const auto character : rowInput)
+            for (const auto [colIndex, character] : row | std::ranges::views::enumerate)
             {
-                if (character == '\0')
-                {
-                    continue;
-                }
-
-                row.emplace_back(character);
                 if (character != '.')
                 {
                     const auto [iterator, _] {mFieldPositions.try_emplace(character)};
-                    iterator->second.push_back(Position{ static_cast<Number>(index), static_cast<Number>(row.size() - 1) });
+                    iterator->second.push_back(Position{ static_cast<Number>(index), static_cast<Number>(colIndex) });
                 }
             }
         }
@@ -134,7 +123,18 @@ private:
         }
     }
 
-    void PerformFirst() override
+    bool WriteParsedInput(utility::BinaryWriter& writer) const override
+    {
+        writer.Write(mData, mFieldPositions, mFieldAntinodeOffsets);
+        return true;
+    }
+
+    bool ReadParsedInput(utility::BinaryReader& reader) override
+    {
+        return reader.ReadAll(mData, mFieldPositions, mFieldAntinodeOffsets);
+    }
+
+    utility::Result PerformFirst() override
     {
         Number result{};
         std::vector<Position> uniquePositions;
@@ -153,11 +153,10 @@ private:
         const auto [eraseFirst, eraseLast] {std::ranges::unique(uniquePositions)};
         uniquePositions.erase(eraseFirst, eraseLast);
         result = uniquePositions.size();
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         Number result{};
         ScratchData scracthData;
@@ -173,13 +172,13 @@ private:
         const auto [eraseFirst, eraseLast] {std::ranges::unique(uniquePositions)};
         uniquePositions.erase(eraseFirst, eraseLast);
         result = uniquePositions.size();
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
-    std::vector<std::vector<Field>> mData;  // Turned out to be unnecessary. could be replaced with width and height.
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
+    utility::Grid<Field> mData;  // Turned out to be unnecessary. could be replaced with width and height.
     std::unordered_map<Field, std::vector<Position>> mFieldPositions;
     std::unordered_map<Field, std::vector<AntinodeOffset>> mFieldAntinodeOffsets;
 };
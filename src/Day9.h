@@ -139,6 +139,7 @@ private:
 
     std::vector<Data> CompactData()
     {
+        utility::ScopedZone zone{ "CompactData", sDay };
         std::vector<Data> compactData{ mData };
         int forwardIndex{ 0 };
         int backwardsIndex{ static_cast<int>(compactData.size() - 1) };
@@ -170,6 +171,7 @@ private:
 
     std::vector<Data> CompactDataWithKeepingItIntact()
     {
+        utility::ScopedZone zone{ "CompactDataWithKeepingItIntact", sDay };
         std::vector<Data> compactData{ mData };
 
         for (auto [index, dataToMigrate] : compactData | std::ranges::views::enumerate | std::ranges::views::reverse)
@@ -204,12 +206,13 @@ private:
     void ReadInput() override
     {
         using namespace std::literals;
-        utility::InputReader<Day9, version> inputReader;
-        mBuffer = inputReader.Read();
+        utility::InputReader<Day9, version> inputReader{ this->GetInputSource() };
+        mInput = inputReader.Map();
+        mBuffer = mInput.GetView();
         InterpretData(mBuffer);
     }
 
-    void PerformFirst() override
+    utility::Result PerformFirst() override
     {
         auto compactedData{ CompactData() };
         int32_t index{ 0 };
@@ -227,8 +230,7 @@ private:
                 ++index;
             }
         }
-        utility::PrintDetails(version, utility::Part::first);
-        std::cout << result << '\n';
+        return result;
     }
 
     void PrintData(std::span<Data> dataToPrint)
@@ -247,7 +249,7 @@ private:
         }
     }
 
-    void PerformSecond() override
+    utility::Result PerformSecond() override
     {
         auto compactedData{ CompactDataWithKeepingItIntact() };
         int32_t index{ 0 };
@@ -267,11 +269,11 @@ private:
                 ++index;
             }
         }
-        utility::PrintDetails(version, utility::Part::second);
-        std::cout << result << '\n';
+        return result;
     }
 
 private:
-    std::string mBuffer;
+    utility::MappedFile mInput;
+    std::string_view mBuffer;
     std::vector<Data> mData;
 };
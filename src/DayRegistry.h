@@ -0,0 +1,144 @@
+#pragma once
+#include "Utility.h"
+#include "CommandLine.h"
+#include "Day.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Performs a day that's been set up for the options it was prepared with.
+using PreparedDay = std::function<utility::RunReport()>;
+
+struct DayEntry
+{
+    std::string_view mDay;
+    int32_t mNumber;
+    std::function<PreparedDay(const utility::RunOptions&)> mPrepare;
+    std::function<utility::TaskGraph::NodeId(utility::TaskGraph&, const utility::RunOptions&, std::optional<utility::TaskGraph::NodeId>, utility::RunReport&)> mSchedule;
+};
+
+class DayRegistry
+{
+public:
+    template<template<utility::InputVersion version = utility::InputVersion::release> class Day>
+        requires utility::IsDayAndHasDayString<Day<>>
+    void Register()
+    {
+        constexpr std::string_view sDay{ Day<>::sDay };
+        const auto firstDigit{ sDay.find_first_of("0123456789") };
+        assert(firstDigit != std::string_view::npos);
+
+        mEntries.emplace_back(sDay, utility::ToNumber(sDay.substr(firstDigit)),
+            [](const utility::RunOptions& options) -> PreparedDay
+            {
+                auto dayWrapper{ std::make_shared<DayWrapper<Day>>() };
+                if (options.mPrefetch)
+                {
+                    dayWrapper->Prefetch(options);
+                }
+                return [dayWrapper, &options] { return dayWrapper->Perform(options); };
+            },
+            [](utility::TaskGraph& taskGraph, const utility::RunOptions& options, std::optional<utility::TaskGraph::NodeId> previousReport, utility::RunReport& report)
+            {
+                return DayWrapper<Day>{}.Schedule(taskGraph, options, previousReport, report);
+            });
+        std::ranges::sort(mEntries, std::less<>{}, &DayEntry::mNumber);
+    }
+
+    [[nodiscard]] const DayEntry* FindDay(int32_t number) const
+    {
+        const auto entryIterator{ std::ranges::find(mEntries, number, &DayEntry::mNumber) };
+        if (entryIterator == mEntries.end())
+        {
+            return nullptr;
+        }
+
+        return &*entryIterator;
+    }
+
+    [[nodiscard]] const std::vector<DayEntry>& GetEntries() const
+    {
+        return mEntries;
+    }
+
+    void PrintDays(std::ostream& outStream) const
+    {
+        for (const auto& entry : mEntries)
+        {
+            outStream << entry.mNumber << ": " << entry.mDay << '\n';
+        }
+    }
+
+    // Returns the merged report of every day that was run.
+    // Returns nothing if any of the requested days isn't registered, nothing is run in that case.
+    [[nodiscard]] std::optional<utility::RunReport> Perform(const utility::RunOptions& options) const
+    {
+        std::vector<const DayEntry*> selectedEntries;
+        if (options.mAllDays)
+        {
+            for (const auto& entry : mEntries)
+            {
+                selectedEntries.push_back(&entry);
+            }
+        }
+        else
+        {
+            for (const auto number : options.mDays)
+            {
+                const auto entry{ FindDay(number) };
+                if (!entry)
+                {
+                    std::cerr << "day " << number << " is not registered\n";
+                    return {};
+                }
+
+                selectedEntries.push_back(entry);
+            }
+        }
+
+        // The next day is prepared before the current one is performed, when prefetching its input is read in the meantime.
+        utility::RunReport result;
+        if (selectedEntries.empty())
+        {
+            return result;
+        }
+
+        // every day and part as a node of one graph, independent days fill the threads the others leave idle
+        if (options.mConcurrent)
+        {
+            utility::TaskGraph taskGraph;
+            std::optional<utility::TaskGraph::NodeId> previousReport;
+            for (const auto entry : selectedEntries)
+            {
+                previousReport = entry->mSchedule(taskGraph, options, previousReport, result);
+            }
+            taskGraph.Run();
+            return result;
+        }
+
+        auto preparedDay{ selectedEntries.front()->mPrepare(options) };
+        for (size_t index = 0; index < selectedEntries.size(); index++)
+        {
+            auto nextPreparedDay{ index + 1 < selectedEntries.size() ? selectedEntries[index + 1]->mPrepare(options) : PreparedDay{} };
+            result.Append(preparedDay());
+            preparedDay = std::move(nextPreparedDay);
+        }
+
+        return result;
+    }
+
+private:
+    std::vector<DayEntry> mEntries;
+};
+
+template<template<utility::InputVersion version = utility::InputVersion::release> class... Days>
+[[nodiscard]] DayRegistry MakeDayRegistry()
+{
+    DayRegistry registry;
+    (registry.Register<Days>(), ...);
+    return registry;
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace utility
+{
+    // Awaiting it continues the coroutine as a task on the pool, the awaiting thread goes on with its own work.
+    class ResumeOnPool
+    {
+    public:
+        explicit ResumeOnPool(ThreadPool& threadPool = GetThreadPool()) : mThreadPool{ threadPool } {}
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            mThreadPool.Submit([handle] { handle.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        ThreadPool& mThreadPool;
+    };
+
+    namespace coroutine
+    {
+        // The state is running, done or the address of the coroutine awaiting the result.
+        static constexpr uintptr_t sRunning{ 0 };
+        static constexpr uintptr_t sDone{ 1 };
+
+        struct PromiseBase
+        {
+            struct FinalAwaiter
+            {
+                [[nodiscard]] bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                // The owner may destroy the frame as soon as it sees done, only locals are touched after the exchange.
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    const auto previousState{ handle.promise().mState.exchange(sDone, std::memory_order_acq_rel) };
+                    if (previousState != sRunning)
+                    {
+                        return std::coroutine_handle<>::from_address(reinterpret_cast<void*>(previousState));
+                    }
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception() noexcept
+            {
+                mException = std::current_exception();
+            }
+
+            std::atomic<uintptr_t> mState{ sRunning };
+            std::exception_ptr mException;
+        };
+
+        template<typename T>
+        struct Promise : PromiseBase
+        {
+            template<typename U>
+            void return_value(U&& value)
+            {
+                mValue.emplace(std::forward<U>(value));
+            }
+
+            std::optional<T> mValue;
+        };
+
+        template<>
+        struct Promise<void> : PromiseBase
+        {
+            void return_void() noexcept {}
+        };
+    }
+
+    // Result of a coroutine that starts right away, typically to co_await ResumeOnPool and carry on there.
+    // The result can be co_awaited once or taken with Get. An exception thrown by the coroutine is rethrown to whoever takes the result.
+    // Destroying an unfinished future waits for the coroutine, its frame can't go away under it.
+    template<typename T = void>
+    class [[nodiscard]] Future
+    {
+    public:
+        struct promise_type : coroutine::Promise<T>
+        {
+            Future get_return_object()
+            {
+                return Future{ std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+        };
+
+        Future() = default;
+
+        Future(Future&& other) noexcept : mHandle{ std::exchange(other.mHandle, {}) } {}
+
+        Future& operator=(Future&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                mHandle = std::exchange(other.mHandle, {});
+            }
+
+            return *this;
+        }
+
+        ~Future()
+        {
+            Reset();
+        }
+
+        Future(const Future&) = delete;
+        Future& operator=(const Future&) = delete;
+
+        [[nodiscard]] bool IsValid() const
+        {
+            return static_cast<bool>(mHandle);
+        }
+
+        [[nodiscard]] bool IsReady() const
+        {
+            return mHandle.promise().mState.load(std::memory_order_acquire) == coroutine::sDone;
+        }
+
+        // Runs pending pool tasks while waiting, like TaskGroup::Wait, so it can be called from a worker as well.
+        T Get()
+        {
+            WaitUntilReady();
+            return TakeResult(mHandle);
+        }
+
+        auto operator co_await() noexcept
+        {
+            struct Awaiter
+            {
+                [[nodiscard]] bool await_ready() const noexcept
+                {
+                    return mHandle.promise().mState.load(std::memory_order_acquire) == coroutine::sDone;
+                }
+
+                // doesn't suspend if the coroutine finished in the meantime
+                bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    auto expectedState{ coroutine::sRunning };
+                    return mHandle.promise().mState.compare_exchange_strong(expectedState, reinterpret_cast<uintptr_t>(awaiting.address()),
+                        std::memory_order_acq_rel);
+                }
+
+                T await_resume()
+                {
+                    return TakeResult(mHandle);
+                }
+
+                std::coroutine_handle<promise_type> mHandle;
+            };
+
+            return Awaiter{ mHandle };
+        }
+
+    private:
+        explicit Future(std::coroutine_handle<promise_type> handle) : mHandle{ handle } {}
+
+        static T TakeResult(std::coroutine_handle<promise_type> handle)
+        {
+            auto& promise{ handle.promise() };
+            if (promise.mException)
+            {
+                std::rethrow_exception(std::exchange(promise.mException, nullptr));
+            }
+
+            if constexpr (!std::is_void_v<T>)
+            {
+                return std::move(*promise.mValue);
+            }
+        }
+
+        void WaitUntilReady() const
+        {
+            auto& threadPool{ GetThreadPool() };
+            while (!IsReady())
+            {
+                if (!threadPool.TryRunTask())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void Reset()
+        {
+            if (!mHandle)
+            {
+                return;
+            }
+
+            WaitUntilReady();
+            std::exchange(mHandle, {}).destroy();
+        }
+
+        std::coroutine_handle<promise_type> mHandle;
+    };
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include "Utility.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace utility
+{
+    // A two dimensional map in one allocation, row after row, each row stride cells apart.
+    // An optional border of sentinel cells surrounds the map, so a step of up to border cells from any cell of the map
+    // stays in the allocation and lands on the sentinel when it leaves the map, no bounds check needed.
+    // Positions are relative to the map, cells of the border have a negative row or column, or one past the size.
+    // Index is the linear index into the allocation, a neighbour is the index plus the offset of the direction.
+    template<typename T, typename Allocator = std::allocator<T>>
+    class Grid
+    {
+    public:
+        using ValueType = T;
+        using Index = ptrdiff_t;
+        using PositionType = int32_t;
+        using Position = utility::Position<PositionType>;
+
+        Grid() = default;
+
+        explicit Grid(const Allocator& allocator) : mCells{ allocator } {}
+
+        Grid(PositionType rowCount, PositionType columnCount, const T& value = {}, PositionType border = 0, const T& borderValue = {}, const Allocator& allocator = {})
+            : mCells{ allocator }
+            , mRowCount{ rowCount }
+            , mColumnCount{ columnCount }
+            , mBorder{ border }
+            , mStride{ columnCount + 2 * border }
+        {
+            assert(rowCount >= 0 && columnCount >= 0 && border >= 0);
+            mCells.assign(static_cast<size_t>((rowCount + 2 * border) * mStride), border == 0 ? value : borderValue);
+            if (border != 0)
+            {
+                for (PositionType row = 0; row < rowCount; row++)
+                {
+                    std::ranges::fill(GetRow(row), value);
+                }
+            }
+        }
+
+        // Same size and border as the other grid, every cell converted, the border included, so indices carry over.
+        template<typename U, typename OtherAllocator, typename Convert>
+        Grid(const Grid<U, OtherAllocator>& other, Convert convert, const Allocator& allocator = {})
+            : mCells{ allocator }
+            , mRowCount{ other.GetRowCount() }
+            , mColumnCount{ other.GetColumnCount() }
+            , mBorder{ other.GetBorder() }
+            , mStride{ other.GetStride() }
+        {
+            const auto otherCells{ other.GetCells() };
+            mCells.reserve(otherCells.size());
+            for (const auto& cell : otherCells)
+            {
+                mCells.push_back(convert(cell));
+            }
+        }
+
+        // Every line up to the first '\0' is a row, empty ones are skipped. All rows have to be as long as the first one,
+        // a runtime_error is thrown otherwise, as the input may come from any file.
+        template<typename Convert>
+        [[nodiscard]] static Grid FromLines(std::string_view data, Convert convert, PositionType border = 0, const T& borderValue = {}, const Allocator& allocator = {})
+        {
+            using namespace std::literals;
+            data = data.substr(0, data.find('\0'));
+            auto lines{ data | std::ranges::views::split("\n"sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; })
+                | std::ranges::views::filter([](std::string_view line) { return !line.empty(); }) };
+
+            PositionType rowCount{ 0 };
+            PositionType columnCount{ 0 };
+            for (const auto line : lines)
+            {
+                if (rowCount == 0)
+                {
+                    columnCount = static_cast<PositionType>(line.size());
+                }
+                else if (line.size() != static_cast<size_t>(columnCount))
+                {
+                    throw std::runtime_error{ "grid row " + std::to_string(rowCount + 1) + " is " + std::to_string(line.size())
+                        + " long instead of " + std::to_string(columnCount) };
+                }
+                ++rowCount;
+            }
+
+            Grid result{ rowCount, columnCount, borderValue, border, borderValue, allocator };
+            PositionType row{ 0 };
+            for (const auto line : lines)
+            {
+                std::ranges::transform(line, result.GetRow(row++).begin(), convert);
+            }
+
+            return result;
+        }
+
+        // For the parse cache, the cells include the border.
+        [[nodiscard]] static std::optional<Grid> FromCells(PositionType rowCount, PositionType columnCount, PositionType border, std::vector<T, Allocator> cells)
+        {
+            if (rowCount < 0 || columnCount < 0 || border < 0
+                || cells.size() != static_cast<size_t>(rowCount + 2 * border) * static_cast<size_t>(columnCount + 2 * border))
+            {
+                return std::nullopt;
+            }
+
+            Grid result;
+            result.mCells = std::move(cells);
+            result.mRowCount = rowCount;
+            result.mColumnCount = columnCount;
+            result.mBorder = border;
+            result.mStride = columnCount + 2 * border;
+            return result;
+        }
+
+        [[nodiscard]] PositionType GetRowCount() const
+        {
+            return mRowCount;
+        }
+
+        [[nodiscard]] PositionType GetColumnCount() const
+        {
+            return mColumnCount;
+        }
+
+        [[nodiscard]] PositionType GetBorder() const
+        {
+            return mBorder;
+        }
+
+        [[nodiscard]] Index GetStride() const
+        {
+            return mStride;
+        }
+
+        [[nodiscard]] bool IsEmpty() const
+        {
+            return mRowCount == 0 || mColumnCount == 0;
+        }
+
+        [[nodiscard]] bool IsInside(Position position) const
+        {
+            return position.mRow >= 0 && position.mRow < mRowCount && position.mCol >= 0 && position.mCol < mColumnCount;
+        }
+
+        [[nodiscard]] Index GetIndex(Position position) const
+        {
+            assert(position.mRow >= -mBorder && position.mRow < mRowCount + mBorder && position.mCol >= -mBorder && position.mCol < mColumnCount + mBorder);
+            return (position.mRow + mBorder) * mStride + position.mCol + mBorder;
+        }
+
+        [[nodiscard]] Position GetPosition(Index index) const
+        {
+            return { static_cast<PositionType>(index / mStride - mBorder), static_cast<PositionType>(index % mStride - mBorder) };
+        }
+
+        // Linear offset of a step in a direction, the same from every cell.
+        [[nodiscard]] Index GetOffset(Position direction) const
+        {
+            return direction.mRow * mStride + direction.mCol;
+        }
+
+        [[nodiscard]] T& operator[](Index index)
+        {
+            return mCells[index];
+        }
+
+        [[nodiscard]] const T& operator[](Index index) const
+        {
+            return mCells[index];
+        }
+
+        [[nodiscard]] T& operator[](Position position)
+        {
+            return mCells[GetIndex(position)];
+        }
+
+        [[nodiscard]] const T& operator[](Position position) const
+        {
+            return mCells[GetIndex(position)];
+        }
+
+        // the cells of the row inside the map, without the border
+        [[nodiscard]] std::span<T> GetRow(PositionType row)
+        {
+            return { mCells.data() + GetIndex({ row, 0 }), static_cast<size_t>(mColumnCount) };
+        }
+
+        [[nodiscard]] std::span<const T> GetRow(PositionType row) const
+        {
+            return { mCells.data() + GetIndex({ row, 0 }), static_cast<size_t>(mColumnCount) };
+        }
+
+        [[nodiscard]] auto GetRows()
+        {
+            return std::ranges::views::iota(PositionType{ 0 }, mRowCount) | std::ranges::views::transform([this](PositionType row) { return GetRow(row); });
+        }
+
+        [[nodiscard]] auto GetRows() const
+        {
+            return std::ranges::views::iota(PositionType{ 0 }, mRowCount) | std::ranges::views::transform([this](PositionType row) { return GetRow(row); });
+        }
+
+        // the column is strided, so it's a view instead of a span
+        [[nodiscard]] auto GetColumn(PositionType column)
+        {
+            return std::ranges::views::iota(PositionType{ 0 }, mRowCount) | std::ranges::views::transform([this, column](PositionType row) -> T& { return (*this)[Position{ row, column }]; });
+        }
+
+        [[nodiscard]] auto GetColumn(PositionType column) const
+        {
+            return std::ranges::views::iota(PositionType{ 0 }, mRowCount) | std::ranges::views::transform([this, column](PositionType row) -> const T& { return (*this)[Position{ row, column }]; });
+        }
+
+        // all cells, the border included
+        [[nodiscard]] std::span<T> GetCells()
+        {
+            return mCells;
+        }
+
+        [[nodiscard]] std::span<const T> GetCells() const
+        {
+            return mCells;
+        }
+
+        [[nodiscard]] std::optional<Position> Find(const T& value) const
+        {
+            for (PositionType row = 0; row < mRowCount; row++)
+            {
+                const auto cells{ GetRow(row) };
+                if (const auto iterator{ std::ranges::find(cells, value) }; iterator != cells.end())
+                {
+                    return Position{ row, static_cast<PositionType>(iterator - cells.begin()) };
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        std::vector<T, Allocator> mCells;
+        PositionType mRowCount{ 0 };
+        PositionType mColumnCount{ 0 };
+        PositionType mBorder{ 0 };
+        Index mStride{ 0 };
+    };
+
+    namespace pmr
+    {
+        template<typename T>
+        using Grid = utility::Grid<T, std::pmr::polymorphic_allocator<T>>;
+    }
+}
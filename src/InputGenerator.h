@@ -0,0 +1,614 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Generators for synthetic puzzle inputs of any size.
+// The size is the approximate number of elements of the input: lines, records, stones, digits or grid cells.
+// std::mt19937_64 is fully specified by the standard, the distributions aren't, so the generators only use
+// the raw engine output to stay deterministic across standard libraries.
+
+namespace utility
+{
+    struct SyntheticInputSettings
+    {
+        size_t mSize{ 1000 };
+        uint64_t mSeed{ 1 };
+    };
+
+    [[nodiscard]] SyntheticInputSettings& GetSyntheticInputSettings()
+    {
+        static SyntheticInputSettings sSettings;
+        return sSettings;
+    }
+}
+
+namespace generator
+{
+    // Part of the generated file names, bump it whenever a generator changes so stale inputs aren't reused.
+    static constexpr uint32_t sGeneratorVersion{ 2 };
+
+    class Random
+    {
+    public:
+        explicit Random(uint64_t seed) : mEngine{ seed } {}
+
+        // Inclusive on both ends.
+        [[nodiscard]] int64_t Uniform(int64_t minimum, int64_t maximum)
+        {
+            const auto range{ static_cast<uint64_t>(maximum - minimum) + 1 };
+            return minimum + static_cast<int64_t>(mEngine() % range);
+        }
+
+        [[nodiscard]] bool Chance(uint32_t percent)
+        {
+            return Uniform(0, 99) < percent;
+        }
+
+        template<typename T>
+        [[nodiscard]] const T& Pick(const std::vector<T>& values)
+        {
+            return values[Uniform(0, static_cast<int64_t>(values.size()) - 1)];
+        }
+
+        template<typename T>
+        void Shuffle(std::vector<T>& values)
+        {
+            for (size_t index = values.size(); index > 1; index--)
+            {
+                std::swap(values[index - 1], values[Uniform(0, static_cast<int64_t>(index) - 1)]);
+            }
+        }
+
+    private:
+        std::mt19937_64 mEngine;
+    };
+
+    using Grid = std::vector<std::string>;
+
+    [[nodiscard]] size_t GetGridSide(size_t size, size_t minimumSide)
+    {
+        return std::max(minimumSide, static_cast<size_t>(std::sqrt(static_cast<double>(size))));
+    }
+
+    // Inputs don't end with a new line, the days would read an empty last line otherwise.
+    [[nodiscard]] std::string JoinLines(const std::vector<std::string>& lines, std::string_view separator = "\n")
+    {
+        std::string result;
+        for (const auto& line : lines)
+        {
+            if (!result.empty())
+            {
+                result.append(separator);
+            }
+            result.append(line);
+        }
+
+        return result;
+    }
+
+    // Two columns of five digit location ids.
+    [[nodiscard]] std::string GenerateDay1(Random& random, size_t size)
+    {
+        std::vector<std::string> lines;
+        std::vector<int64_t> sharedIds;
+        for (size_t line = 0; line < size; line++)
+        {
+            const auto first{ random.Uniform(10000, 99999) };
+            // repeat ids so the similarity score of part two isn't always zero
+            const auto second{ !sharedIds.empty() && random.Chance(30) ? random.Pick(sharedIds) : random.Uniform(10000, 99999) };
+            sharedIds.push_back(first);
+            lines.push_back(std::to_string(first).append("   ").append(std::to_string(second)));
+        }
+
+        return JoinLines(lines);
+    }
+
+    // Reports of 5 to 8 levels, roughly half of them safe.
+    [[nodiscard]] std::string GenerateDay2(Random& random, size_t size)
+    {
+        std::vector<std::string> lines;
+        for (size_t line = 0; line < size; line++)
+        {
+            const auto levelCount{ random.Uniform(5, 8) };
+            const auto direction{ random.Chance(50) ? 1 : -1 };
+            int64_t level{ direction > 0 ? random.Uniform(1, 30) : random.Uniform(60, 90) };
+            std::string report{ std::to_string(level) };
+            for (int64_t index = 1; index < levelCount; index++)
+            {
+                level += direction * (random.Chance(90) ? random.Uniform(1, 3) : random.Uniform(-2, 6));
+                level = std::max<int64_t>(level, 1);
+                report.append(" ").append(std::to_string(level));
+            }
+            lines.push_back(std::move(report));
+        }
+
+        return JoinLines(lines);
+    }
+
+    // Corrupted memory with valid and broken mul instructions, do() and don't().
+    [[nodiscard]] std::string GenerateDay3(Random& random, size_t size)
+    {
+        static const std::vector<std::string> sNoise{ "x", "%", "&", "[", "]", "!", "@", "^", "(", ")", "+", "?", "<", ">", "'", " ", "from()", "what()", "mul[3,7]", "mul(4*", "mul ( 2 , 4 )", "do_not_mul(5,5)" };
+        std::vector<std::string> lines;
+        std::string line;
+        for (size_t instruction = 0; instruction < size; instruction++)
+        {
+            const auto noiseCount{ random.Uniform(0, 4) };
+            for (int64_t noise = 0; noise < noiseCount; noise++)
+            {
+                line.append(random.Pick(sNoise));
+            }
+
+            const auto kind{ random.Uniform(0, 9) };
+            if (kind == 0)
+            {
+                line.append("do()");
+            }
+            else if (kind == 1)
+            {
+                line.append("don't()");
+            }
+            else
+            {
+                line.append("mul(").append(std::to_string(random.Uniform(1, 999))).append(",").append(std::to_string(random.Uniform(1, 999))).append(")");
+            }
+
+            if (line.size() > 3000)
+            {
+                lines.push_back(std::move(line));
+                line.clear();
+            }
+        }
+        lines.push_back(std::move(line));
+
+        return JoinLines(lines);
+    }
+
+    // Square letter grid of X, M, A and S.
+    [[nodiscard]] std::string GenerateDay4(Random& random, size_t size)
+    {
+        static constexpr std::string_view sLetters{ "XMAS" };
+        const auto side{ GetGridSide(size, 4) };
+        Grid grid(side, std::string(side, '.'));
+        for (auto& row : grid)
+        {
+            for (auto& field : row)
+            {
+                field = sLetters[random.Uniform(0, 3)];
+            }
+        }
+
+        return JoinLines(grid);
+    }
+
+    // Ordering rules for every pair of 49 pages taken from a hidden total order, so the rules never contradict.
+    // Updates are odd length subsets of the pages in random order.
+    [[nodiscard]] std::string GenerateDay5(Random& random, size_t size)
+    {
+        std::vector<int64_t> pages(49);
+        std::iota(pages.begin(), pages.end(), 11);
+        random.Shuffle(pages);
+
+        std::vector<std::string> lines;
+        for (size_t first = 0; first < pages.size(); first++)
+        {
+            for (size_t second = first + 1; second < pages.size(); second++)
+            {
+                lines.push_back(std::to_string(pages[first]).append("|").append(std::to_string(pages[second])));
+            }
+        }
+        random.Shuffle(lines);
+        lines.emplace_back();
+
+        for (size_t update = 0; update < size; update++)
+        {
+            auto updatePages{ pages };
+            random.Shuffle(updatePages);
+            updatePages.resize(random.Uniform(2, 11) * 2 + 1);
+            if (random.Chance(50))
+            {
+                // keep the hidden order, so about half of the updates are already correct
+                std::ranges::sort(updatePages, std::less<>{}, [&pages](int64_t page) {return std::ranges::find(pages, page) - pages.begin(); });
+            }
+
+            std::string line;
+            for (const auto page : updatePages)
+            {
+                line.append(line.empty() ? "" : ",").append(std::to_string(page));
+            }
+            lines.push_back(std::move(line));
+        }
+
+        return JoinLines(lines);
+    }
+
+    // Returns the number of steps a guard starting at the given position takes to leave the grid.
+    // Returns nothing if the guard gets stuck in a loop.
+    [[nodiscard]] std::optional<size_t> GetGuardPathLength(const Grid& grid, int64_t row, int64_t col)
+    {
+        static constexpr std::array<std::pair<int64_t, int64_t>, 4> sDirections{ std::pair<int64_t, int64_t>{-1, 0}, {0, 1}, {1, 0}, {0, -1} };
+        const auto side{ static_cast<int64_t>(grid.size()) };
+        std::vector<uint8_t> visitedDirections(grid.size() * grid.size(), 0);
+        size_t direction{ 0 };
+        size_t steps{ 0 };
+        while (true)
+        {
+            auto& visited{ visitedDirections[row * side + col] };
+            if (visited & (1 << direction))
+            {
+                return {};
+            }
+            visited |= 1 << direction;
+
+            const auto nextRow{ row + sDirections[direction].first };
+            const auto nextCol{ col + sDirections[direction].second };
+            if (nextRow < 0 || nextRow >= side || nextCol < 0 || nextCol >= side)
+            {
+                return steps;
+            }
+
+            if (grid[nextRow][nextCol] == '#')
+            {
+                direction = (direction + 1) % sDirections.size();
+                continue;
+            }
+
+            row = nextRow;
+            col = nextCol;
+            ++steps;
+        }
+    }
+
+    // Lab map with a few obstructions and a guard facing up, that leaves the map without looping.
+    // Maps where the guard leaves right away are rejected too, they wouldn't exercise the walk.
+    [[nodiscard]] std::string GenerateDay6(Random& random, size_t size)
+    {
+        const auto side{ GetGridSide(size, 4) };
+        while (true)
+        {
+            Grid grid(side, std::string(side, '.'));
+            for (auto& row : grid)
+            {
+                for (auto& field : row)
+                {
+                    field = random.Chance(5) ? '#' : '.';
+                }
+            }
+
+            const auto guardRow{ random.Uniform(0, side - 1) };
+            const auto guardCol{ random.Uniform(0, side - 1) };
+            grid[guardRow][guardCol] = '^';
+            if (const auto pathLength{ GetGuardPathLength(grid, guardRow, guardCol) }; pathLength && *pathLength >= 2 * side)
+            {
+                return JoinLines(grid);
+            }
+        }
+    }
+
+    // Calibration equations of 2 to 8 operands, about half of them solvable with +, * and ||.
+    [[nodiscard]] std::string GenerateDay7(Random& random, size_t size)
+    {
+        std::vector<std::string> lines;
+        for (size_t line = 0; line < size; line++)
+        {
+            const auto operandCount{ random.Uniform(2, 8) };
+            std::vector<uint64_t> operands;
+            for (int64_t index = 0; index < operandCount; index++)
+            {
+                operands.push_back(random.Uniform(1, 99));
+            }
+
+            uint64_t target{ operands.front() };
+            for (const auto operand : operands | std::ranges::views::drop(1))
+            {
+                switch (random.Uniform(0, 2))
+                {
+                case 0:
+                {
+                    target += operand;
+                }
+                break;
+                case 1:
+                {
+                    target *= operand;
+                }
+                break;
+                case 2:
+                {
+                    target = std::stoull(std::to_string(target).append(std::to_string(operand)));
+                }
+                break;
+                }
+            }
+            if (random.Chance(50))
+            {
+                target += random.Uniform(1, 9);
+            }
+
+            std::string equation{ std::to_string(target).append(":") };
+            for (const auto operand : operands)
+            {
+                equation.append(" ").append(std::to_string(operand));
+            }
+            lines.push_back(std::move(equation));
+        }
+
+        return JoinLines(lines);
+    }
+
+    // Map with antennas of single character frequencies.
+    [[nodiscard]] std::string GenerateDay8(Random& random, size_t size)
+    {
+        static constexpr std::string_view sFrequencies{ "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+        const auto side{ GetGridSide(size, 4) };
+        Grid grid(side, std::string(side, '.'));
+        for (auto& row : grid)
+        {
+            for (auto& field : row)
+            {
+                if (random.Chance(4))
+                {
+                    field = sFrequencies[random.Uniform(0, sFrequencies.size() - 1)];
+                }
+            }
+        }
+
+        return JoinLines(grid);
+    }
+
+    // Disk map alternating file and free space lengths, starting and ending with a file.
+    [[nodiscard]] std::string GenerateDay9(Random& random, size_t size)
+    {
+        std::string result;
+        const auto digitCount{ std::max<size_t>(size | 1, 1) };
+        for (size_t index = 0; index < digitCount; index++)
+        {
+            const bool isFile{ index % 2 == 0 };
+            result.push_back(static_cast<char>('0' + (isFile ? random.Uniform(1, 9) : random.Uniform(0, 9))));
+        }
+
+        return result;
+    }
+
+    // Topographic map of random heights with hiking trails from 0 to 9 stamped on top.
+    [[nodiscard]] std::string GenerateDay10(Random& random, size_t size)
+    {
+        const auto side{ static_cast<int64_t>(GetGridSide(size, 4)) };
+        Grid grid(side, std::string(side, '.'));
+        for (auto& row : grid)
+        {
+            for (auto& field : row)
+            {
+                field = static_cast<char>('0' + random.Uniform(0, 9));
+            }
+        }
+
+        const auto trailCount{ std::max<int64_t>(side * side / 20, 1) };
+        for (int64_t trail = 0; trail < trailCount; trail++)
+        {
+            auto row{ random.Uniform(0, side - 1) };
+            auto col{ random.Uniform(0, side - 1) };
+            for (char height = '0'; height <= '9'; height++)
+            {
+                grid[row][col] = height;
+                switch (random.Uniform(0, 3))
+                {
+                case 0:
+                {
+                    row = std::max<int64_t>(row - 1, 0);
+                }
+                break;
+                case 1:
+                {
+                    row = std::min<int64_t>(row + 1, side - 1);
+                }
+                break;
+                case 2:
+                {
+                    col = std::max<int64_t>(col - 1, 0);
+                }
+                break;
+                case 3:
+                {
+                    col = std::min<int64_t>(col + 1, side - 1);
+                }
+                break;
+                }
+            }
+        }
+
+        return JoinLines(grid);
+    }
+
+    // A single line of engraved stones.
+    [[nodiscard]] std::string GenerateDay11(Random& random, size_t size)
+    {
+        std::string result;
+        for (size_t stone = 0; stone < std::max<size_t>(size, 1); stone++)
+        {
+            result.append(result.empty() ? "" : " ").append(std::to_string(random.Uniform(0, 999999)));
+        }
+
+        return result;
+    }
+
+    // Garden plots grown from as many seeds as the map is wide, so regions get larger with the map like in the release input.
+    [[nodiscard]] std::string GenerateDay12(Random& random, size_t size)
+    {
+        const auto side{ static_cast<int64_t>(GetGridSide(size, 2)) };
+        Grid grid(side, std::string(side, '.'));
+        std::deque<std::pair<int64_t, int64_t>> openFields;
+        for (int64_t seed = 0; seed < side; seed++)
+        {
+            const auto row{ random.Uniform(0, side - 1) };
+            const auto col{ random.Uniform(0, side - 1) };
+            grid[row][col] = static_cast<char>('A' + random.Uniform(0, 25));
+            openFields.emplace_back(row, col);
+        }
+
+        while (!openFields.empty())
+        {
+            const auto [row, col] {openFields.front()};
+            openFields.pop_front();
+            for (const auto& [rowOffset, colOffset] : { std::pair<int64_t, int64_t>{-1, 0}, {1, 0}, {0, -1}, {0, 1} })
+            {
+                const auto nextRow{ row + rowOffset };
+                const auto nextCol{ col + colOffset };
+                if (nextRow >= 0 && nextRow < side && nextCol >= 0 && nextCol < side && grid[nextRow][nextCol] == '.')
+                {
+                    grid[nextRow][nextCol] = grid[row][col];
+                    openFields.emplace_back(nextRow, nextCol);
+                }
+            }
+        }
+
+        return JoinLines(grid);
+    }
+
+    // Claw machines, about half of them winnable.
+    [[nodiscard]] std::string GenerateDay13(Random& random, size_t size)
+    {
+        std::vector<std::string> machines;
+        for (size_t machine = 0; machine < std::max<size_t>(size, 1); machine++)
+        {
+            // one button leans towards X and the other towards Y, so the far away prizes of part two stay reachable
+            auto aX{ random.Uniform(50, 99) };
+            auto aY{ random.Uniform(10, 45) };
+            auto bX{ random.Uniform(10, 45) };
+            auto bY{ random.Uniform(50, 99) };
+            if (random.Chance(50))
+            {
+                std::swap(aX, bX);
+                std::swap(aY, bY);
+            }
+            const auto aPresses{ random.Uniform(1, 100) };
+            const auto bPresses{ random.Uniform(1, 100) };
+            auto prizeX{ aX * aPresses + bX * bPresses };
+            auto prizeY{ aY * aPresses + bY * bPresses };
+            if (random.Chance(50))
+            {
+                prizeX += random.Uniform(1, 9);
+            }
+
+            machines.push_back(std::string{ "Button A: X+" }.append(std::to_string(aX)).append(", Y+").append(std::to_string(aY))
+                .append("\nButton B: X+").append(std::to_string(bX)).append(", Y+").append(std::to_string(bY))
+                .append("\nPrize: X=").append(std::to_string(prizeX)).append(", Y=").append(std::to_string(prizeY)));
+        }
+
+        return JoinLines(machines, "\n\n");
+    }
+
+    // Robots on the 101 wide and 103 tall release sized space.
+    [[nodiscard]] std::string GenerateDay14(Random& random, size_t size)
+    {
+        std::vector<std::string> lines;
+        for (size_t robot = 0; robot < std::max<size_t>(size, 1); robot++)
+        {
+            lines.push_back(std::string{ "p=" }.append(std::to_string(random.Uniform(0, 100))).append(",").append(std::to_string(random.Uniform(0, 102)))
+                .append(" v=").append(std::to_string(random.Uniform(-99, 99))).append(",").append(std::to_string(random.Uniform(-99, 99))));
+        }
+
+        return JoinLines(lines);
+    }
+
+    // Walled in warehouse with boxes and a robot, followed by size moves.
+    [[nodiscard]] std::string GenerateDay15(Random& random, size_t size)
+    {
+        static constexpr std::string_view sMoves{ "^v<>" };
+        const auto side{ static_cast<int64_t>(GetGridSide(size / 8, 8)) };
+        Grid grid(side, std::string(side, '#'));
+        for (int64_t row = 1; row < side - 1; row++)
+        {
+            for (int64_t col = 1; col < side - 1; col++)
+            {
+                grid[row][col] = random.Chance(5) ? '#' : random.Chance(25) ? 'O' : '.';
+            }
+        }
+        grid[random.Uniform(1, side - 2)][random.Uniform(1, side - 2)] = '@';
+
+        std::vector<std::string> moveLines;
+        std::string moves;
+        for (size_t move = 0; move < std::max<size_t>(size, 1); move++)
+        {
+            moves.push_back(sMoves[random.Uniform(0, 3)]);
+            if (moves.size() == 1000)
+            {
+                moveLines.push_back(std::move(moves));
+                moves.clear();
+            }
+        }
+        if (!moves.empty())
+        {
+            moveLines.push_back(std::move(moves));
+        }
+
+        return JoinLines(grid).append("\n\n").append(JoinLines(moveLines));
+    }
+
+    // Walled in maze with S in the bottom left and E in the top right corner.
+    // The bottom row and the right column are kept open, so there's always a path.
+    [[nodiscard]] std::string GenerateDay16(Random& random, size_t size)
+    {
+        const auto side{ static_cast<int64_t>(GetGridSide(size, 5)) };
+        Grid grid(side, std::string(side, '#'));
+        for (int64_t row = 1; row < side - 1; row++)
+        {
+            for (int64_t col = 1; col < side - 1; col++)
+            {
+                const bool isKeptOpen{ row == side - 2 || col == side - 2 };
+                grid[row][col] = !isKeptOpen && random.Chance(30) ? '#' : '.';
+            }
+        }
+        grid[side - 2][1] = 'S';
+        grid[1][side - 2] = 'E';
+
+        return JoinLines(grid);
+    }
+
+    using GeneratorFunction = std::function<std::string(Random&, size_t)>;
+
+    static const std::unordered_map<std::string_view, GeneratorFunction> sGenerators
+    {
+        {"day1", &GenerateDay1},
+        {"day2", &GenerateDay2},
+        {"day3", &GenerateDay3},
+        {"day4", &GenerateDay4},
+        {"day5", &GenerateDay5},
+        {"day6", &GenerateDay6},
+        {"day7", &GenerateDay7},
+        {"day8", &GenerateDay8},
+        {"day9", &GenerateDay9},
+        {"day10", &GenerateDay10},
+        {"day11", &GenerateDay11},
+        {"day12", &GenerateDay12},
+        {"day13", &GenerateDay13},
+        {"day14", &GenerateDay14},
+        {"day15", &GenerateDay15},
+        {"day16", &GenerateDay16},
+    };
+
+    // Returns an empty string for days without a generator.
+    [[nodiscard]] std::string Generate(std::string_view day, const utility::SyntheticInputSettings& settings)
+    {
+        const auto generatorIterator{ sGenerators.find(day) };
+        if (generatorIterator == sGenerators.end())
+        {
+            return {};
+        }
+
+        Random random{ settings.mSeed };
+        return generatorIterator->second(random, settings.mSize);
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utility
+{
+    // Read only view of a whole file, backed by a memory mapping.
+    // Falls back to reading the file into memory if it can't be mapped, e.g. for pipes or empty files.
+    // The view stays valid as long as the MappedFile lives, moving it doesn't invalidate the view.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::filesystem::path& path)
+        {
+            if (!Map(path))
+            {
+                ReadIntoMemory(path);
+            }
+        }
+
+        // Streams such as std::cin can't be mapped, their content is read into memory.
+        explicit MappedFile(std::istream& inStream)
+        {
+            ReadIntoMemory(inStream);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : mData{ std::exchange(other.mData, nullptr) }
+            , mSize{ std::exchange(other.mSize, 0) }
+            , mIsMapped{ std::exchange(other.mIsMapped, false) }
+            , mFallbackBuffer{ std::move(other.mFallbackBuffer) }
+        {
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Unmap();
+                mData = std::exchange(other.mData, nullptr);
+                mSize = std::exchange(other.mSize, 0);
+                mIsMapped = std::exchange(other.mIsMapped, false);
+                mFallbackBuffer = std::move(other.mFallbackBuffer);
+            }
+
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            Unmap();
+        }
+
+        [[nodiscard]] std::string_view GetView() const
+        {
+            return { mData, mSize };
+        }
+
+        [[nodiscard]] bool IsMapped() const
+        {
+            return mIsMapped;
+        }
+
+    private:
+#ifdef _WIN32
+        [[nodiscard]] bool Map(const std::filesystem::path& path)
+        {
+            const HANDLE file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER fileSize{};
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            {
+                CloseHandle(file);
+                return false;
+            }
+
+            // the view keeps the mapping alive, both handles can be closed right away
+            const HANDLE mapping{ CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+            CloseHandle(file);
+            if (!mapping)
+            {
+                return false;
+            }
+
+            const auto view{ MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+            CloseHandle(mapping);
+            if (!view)
+            {
+                return false;
+            }
+
+            WIN32_MEMORY_RANGE_ENTRY range{ view, static_cast<SIZE_T>(fileSize.QuadPart) };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            mData = static_cast<const char*>(view);
+            mSize = static_cast<size_t>(fileSize.QuadPart);
+            mIsMapped = true;
+            return true;
+        }
+
+        void Unmap()
+        {
+            if (mIsMapped)
+            {
+                UnmapViewOfFile(mData);
+                mIsMapped = false;
+            }
+        }
+#else
+        [[nodiscard]] bool Map(const std::filesystem::path& path)
+        {
+            const int file{ open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+            if (file < 0)
+            {
+                return false;
+            }
+
+            struct stat fileStatus {};
+            if (fstat(file, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode) || fileStatus.st_size == 0)
+            {
+                close(file);
+                return false;
+            }
+
+            // the mapping keeps the file alive, the descriptor can be closed right away
+            const auto size{ static_cast<size_t>(fileStatus.st_size) };
+            void* view{ mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0) };
+            close(file);
+            if (view == MAP_FAILED)
+            {
+                return false;
+            }
+
+            // the inputs are parsed front to back, start faulting the pages in while the parsing begins
+            madvise(view, size, MADV_SEQUENTIAL);
+            madvise(view, size, MADV_WILLNEED);
+            mData = static_cast<const char*>(view);
+            mSize = size;
+            mIsMapped = true;
+            return true;
+        }
+
+        void Unmap()
+        {
+            if (mIsMapped)
+            {
+                munmap(const_cast<char*>(mData), mSize);
+                mIsMapped = false;
+            }
+        }
+#endif
+
+        void ReadIntoMemory(const std::filesystem::path& path)
+        {
+            if (std::ifstream inputReader{ path, std::ios::binary })
+            {
+                ReadIntoMemory(inputReader);
+            }
+        }
+
+        void ReadIntoMemory(std::istream& inStream)
+        {
+            mFallbackBuffer.assign(std::istreambuf_iterator<char>{ inStream }, std::istreambuf_iterator<char>{});
+            mData = mFallbackBuffer.data();
+            mSize = mFallbackBuffer.size();
+        }
+
+        const char* mData{ nullptr };
+        size_t mSize{ 0 };
+        bool mIsMapped{ false };
+        std::vector<char> mFallbackBuffer;      // a vector keeps its heap buffer when moved, unlike a short std::string
+    };
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define AOC24_SCAN_NUMBERS_SIMD
+#endif
+
+namespace utility
+{
+    namespace scanner
+    {
+        [[nodiscard]] constexpr bool IsDigit(char character)
+        {
+            return character >= '0' && character <= '9';
+        }
+
+#if defined(__AVX2__)
+        static constexpr size_t sBlockSize{ 32 };
+
+        // Bit i is set when byte i of the block is a digit. Bytes above 0x7F are negative as signed bytes, so they never pass the first compare.
+        [[nodiscard]] inline uint32_t GetDigitMask(const char* block)
+        {
+            const auto bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)) };
+            const auto isDigit{ _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), bytes)) };
+            return static_cast<uint32_t>(_mm256_movemask_epi8(isDigit));
+        }
+#elif defined(AOC24_SCAN_NUMBERS_SIMD)
+        static constexpr size_t sBlockSize{ 16 };
+
+        // Bit i is set when byte i of the block is a digit. Bytes above 0x7F are negative as signed bytes, so they never pass the first compare.
+        [[nodiscard]] inline uint32_t GetDigitMask(const char* block)
+        {
+            const auto bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)) };
+            const auto isDigit{ _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), bytes)) };
+            return static_cast<uint32_t>(_mm_movemask_epi8(isDigit));
+        }
+#endif
+
+        // Index of the first digit at or after index, the size of the data if there is none.
+        // Whole blocks are classified at once, the tail that doesn't fill a block is checked byte by byte.
+        [[nodiscard]] inline size_t FindDigit(std::string_view data, size_t index)
+        {
+#ifdef AOC24_SCAN_NUMBERS_SIMD
+            for (; index + sBlockSize <= data.size(); index += sBlockSize)
+            {
+                if (const auto digitMask{ GetDigitMask(data.data() + index) }; digitMask != 0)
+                {
+                    return index + std::countr_zero(digitMask);
+                }
+            }
+#endif
+            while (index < data.size() && !IsDigit(data[index]))
+            {
+                index++;
+            }
+
+            return index;
+        }
+
+        // The eight bytes starting at data, the first one in the lowest byte.
+        [[nodiscard]] inline uint64_t LoadEightBytes(const char* data)
+        {
+            uint64_t result;
+            std::memcpy(&result, data, sizeof(result));
+            if constexpr (std::endian::native == std::endian::big)
+            {
+                result = std::byteswap(result);
+            }
+
+            return result;
+        }
+
+        // A byte is a digit when its high nibble is 3 and adding 6 doesn't carry into the high nibble.
+        [[nodiscard]] constexpr bool IsEightDigits(uint64_t chunk)
+        {
+            return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+        }
+
+        // Combines neighbouring digits into two digit, then four digit, then the eight digit value, three multiplies in all.
+        [[nodiscard]] constexpr uint64_t ParseEightDigits(uint64_t chunk)
+        {
+            chunk -= 0x3030303030303030;
+            chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+            chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+            return (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFF;
+        }
+
+        static constexpr size_t sMaxDigits{ std::numeric_limits<uint64_t>::digits10 };
+
+        static constexpr auto sPowersOf10{ []
+            {
+                std::array<uint64_t, sMaxDigits + 1> result{};
+                result[0] = 1;
+                for (size_t index = 1; index < result.size(); index++)
+                {
+                    result[index] = result[index - 1] * 10;
+                }
+                return result;
+            }() };
+
+        // Value of 8 to 19 digits, which always fits, nothing if a character isn't a digit.
+        // Eight digits are converted at a time, the last few by reading the eight bytes that end with them
+        // and turning the ones already converted into leading zeros.
+        [[nodiscard]] inline std::optional<uint64_t> ParseDigits(std::string_view digits)
+        {
+            uint64_t result{};
+            size_t index{ 0 };
+            for (; index + 8 <= digits.size(); index += 8)
+            {
+                const auto chunk{ LoadEightBytes(digits.data() + index) };
+                if (!IsEightDigits(chunk))
+                {
+                    return std::nullopt;
+                }
+                result = result * sPowersOf10[8] + ParseEightDigits(chunk);
+            }
+
+            if (const auto remainingDigits{ digits.size() - index }; remainingDigits > 0)
+            {
+                const uint64_t convertedMask{ (uint64_t{ 1 } << (8 * (8 - remainingDigits))) - 1 };
+                const auto chunk{ (LoadEightBytes(digits.data() + digits.size() - 8) & ~convertedMask) | (0x3030303030303030 & convertedMask) };
+                if (!IsEightDigits(chunk))
+                {
+                    return std::nullopt;
+                }
+                result = result * sPowersOf10[remainingDigits] + ParseEightDigits(chunk);
+            }
+
+            return result;
+        }
+    }
+
+    enum class NumberError
+    {
+        empty,
+        invalidCharacter,
+        overflow,
+    };
+
+    // Digits with a minus in front for signed types, nothing else. Leading zeros are fine.
+    // Numbers that can't overflow T skip the range check, the digit count alone tells.
+    template<std::integral T>
+    [[nodiscard]] std::expected<T, NumberError> TryToNumber(std::string_view data)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        bool isNegative{ false };
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (!data.empty() && data.front() == '-')
+            {
+                isNegative = true;
+                data.remove_prefix(1);
+            }
+        }
+
+        if (data.empty())
+        {
+            return std::unexpected{ NumberError::empty };
+        }
+
+        constexpr size_t sSafeDigits{ std::numeric_limits<T>::digits10 };
+        constexpr size_t sMaxDigits{ sSafeDigits + 1 };
+        if (data.size() > sSafeDigits)
+        {
+            while (data.size() > 1 && data.front() == '0')
+            {
+                data.remove_prefix(1);
+            }
+
+            if (data.size() > sMaxDigits)
+            {
+                return std::unexpected{ std::ranges::all_of(data, scanner::IsDigit) ? NumberError::overflow : NumberError::invalidCharacter };
+            }
+        }
+
+        // short numbers are the common case, they don't pay for a call
+        uint64_t value{};
+        if (data.size() < 8)
+        {
+            for (const char character : data)
+            {
+                if (!scanner::IsDigit(character))
+                {
+                    return std::unexpected{ NumberError::invalidCharacter };
+                }
+                value = value * 10 + (character & 0x0F);
+            }
+        }
+        else
+        {
+            // only uint64_t can have one digit more than ParseDigits takes
+            const auto parsedDigits{ scanner::ParseDigits(data.substr(0, std::min(data.size(), scanner::sMaxDigits))) };
+            if (!parsedDigits)
+            {
+                return std::unexpected{ NumberError::invalidCharacter };
+            }
+            value = *parsedDigits;
+        }
+
+        if (data.size() > sSafeDigits)
+        {
+            if (data.size() > scanner::sMaxDigits)
+            {
+                const char lastDigit{ data.back() };
+                if (!scanner::IsDigit(lastDigit))
+                {
+                    return std::unexpected{ NumberError::invalidCharacter };
+                }
+                if (value > (std::numeric_limits<uint64_t>::max() - (lastDigit & 0x0F)) / 10)
+                {
+                    return std::unexpected{ NumberError::overflow };
+                }
+                value = value * 10 + (lastDigit & 0x0F);
+            }
+
+            // the magnitude of the minimum is one more than the maximum
+            if (value > static_cast<uint64_t>(std::numeric_limits<T>::max()) + (isNegative ? 1 : 0))
+            {
+                return std::unexpected{ NumberError::overflow };
+            }
+        }
+
+        return isNegative ? static_cast<T>(Unsigned{} - static_cast<Unsigned>(value)) : static_cast<T>(value);
+    }
+
+    // Finds every run of digits, a minus right in front makes it negative, like GetNumbers does.
+    // Writes as many numbers as fit into the output and returns how many there are, so a caller can tell that it ran out of room.
+    // Doesn't allocate, the numbers aren't checked for overflow. A number too long for T wraps around,
+    // the digits past the first digits10 + 1 are skipped, they'd only keep it wrapping.
+    template<std::integral T, size_t extent>
+    [[nodiscard]] size_t ScanNumbers(std::string_view data, std::span<T, extent> output)
+    {
+        // unsigned, so wrapping around is defined
+        using Unsigned = std::make_unsigned_t<T>;
+        static constexpr size_t sMaxDigitCount{ std::numeric_limits<T>::digits10 + 1 };
+
+        size_t result{ 0 };
+        size_t index{ scanner::FindDigit(data, 0) };
+        while (index < data.size())
+        {
+            const bool isNegative{ index > 0 && data[index - 1] == '-' };
+            const auto digitsEnd{ std::min(data.size(), index + sMaxDigitCount) };
+            Unsigned number{};
+            for (; index < digitsEnd && scanner::IsDigit(data[index]); index++)
+            {
+                number = static_cast<Unsigned>(number * 10u + static_cast<Unsigned>(data[index] & 0x0F));
+            }
+            for (; index < data.size() && scanner::IsDigit(data[index]); index++) {}
+
+            if (result < output.size())
+            {
+                output[result] = static_cast<T>(isNegative ? static_cast<Unsigned>(Unsigned{} - number) : number);
+            }
+            ++result;
+            index = scanner::FindDigit(data, index);
+        }
+
+        return result;
+    }
+}
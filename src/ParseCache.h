@@ -0,0 +1,431 @@
+#pragma once
+#include "Grid.h"
+#include "MappedFile.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace utility
+{
+    // Bumped when the layout of the cache file itself changes, days version their own payload with sParseCacheVersion.
+    static constexpr uint32_t sParseCacheFormatVersion{ 1 };
+    static constexpr std::array<char, 8> sParseCacheMagic{ 'A', 'O', 'C', '2', '4', 'P', 'C', '\0' };
+
+    struct ParseCacheOptions
+    {
+        bool mEnabled{ false };
+        std::filesystem::path mDirectory;       // defaults to .parse_cache in the input directory
+    };
+
+    // 64 bit FNV-1a, not cryptographic, but plenty to tell inputs apart.
+    [[nodiscard]] constexpr uint64_t HashFnv1a(std::string_view data)
+    {
+        uint64_t result{ 14695981039346656037ull };
+        for (const char character : data)
+        {
+            result ^= static_cast<unsigned char>(character);
+            result *= 1099511628211ull;
+        }
+
+        return result;
+    }
+
+    static_assert(HashFnv1a("") == 14695981039346656037ull);
+    static_assert(HashFnv1a("a") == 0xaf63dc4c8601ec8cull);
+
+    // Appends values in native byte order, the cache is only ever read back on the machine that wrote it.
+    // Trivially copyable values are copied as they are, containers are prefixed with their size.
+    class BinaryWriter
+    {
+    public:
+        template<typename... T>
+        void Write(const T&... values)
+        {
+            (WriteValue(values), ...);
+        }
+
+        [[nodiscard]] std::string_view GetView() const
+        {
+            return mBuffer;
+        }
+
+    private:
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void WriteValue(const T& value)
+        {
+            mBuffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T, typename U>
+        void WriteValue(const std::pair<T, U>& value)
+        {
+            WriteValue(value.first);
+            WriteValue(value.second);
+        }
+
+        template<typename T>
+        void WriteValue(const std::vector<T>& values)
+        {
+            WriteValue(static_cast<uint64_t>(values.size()));
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                mBuffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+            }
+            else
+            {
+                for (const auto& value : values)
+                {
+                    WriteValue(value);
+                }
+            }
+        }
+
+        template<typename T, typename Allocator>
+            requires std::is_trivially_copyable_v<T>
+        void WriteValue(const Grid<T, Allocator>& grid)
+        {
+            WriteValue(grid.GetRowCount());
+            WriteValue(grid.GetColumnCount());
+            WriteValue(grid.GetBorder());
+            const auto cells{ grid.GetCells() };
+            mBuffer.append(reinterpret_cast<const char*>(cells.data()), cells.size_bytes());
+        }
+
+        template<typename T>
+        void WriteValue(const std::unordered_set<T>& values)
+        {
+            WriteValue(static_cast<uint64_t>(values.size()));
+            for (const auto& value : values)
+            {
+                WriteValue(value);
+            }
+        }
+
+        template<typename T, typename U>
+        void WriteValue(const std::unordered_map<T, U>& values)
+        {
+            WriteValue(static_cast<uint64_t>(values.size()));
+            for (const auto& [key, value] : values)
+            {
+                WriteValue(key);
+                WriteValue(value);
+            }
+        }
+
+        std::string mBuffer;
+    };
+
+    // Counterpart of BinaryWriter. A Read either reads all of its values or, when the data ends early,
+    // leaves them untouched, so a day never ends up with half of a cached input.
+    class BinaryReader
+    {
+    public:
+        explicit BinaryReader(std::string_view data) : mData{ data } {}
+
+        template<typename... T>
+        [[nodiscard]] bool Read(T&... values)
+        {
+            std::tuple<T...> readValues;
+            const bool isRead{ std::apply([this](auto&... readValue) { return (ReadValue(readValue) && ...); }, readValues) };
+            if (isRead)
+            {
+                std::tie(values...) = std::move(readValues);
+            }
+
+            return isRead;
+        }
+
+        // Like Read, but the values are only assigned when they were the last thing in the data, a cached input is read in one go.
+        template<typename... T>
+        [[nodiscard]] bool ReadAll(T&... values)
+        {
+            std::tuple<T...> readValues;
+            const bool isRead{ std::apply([this](auto&... readValue) { return (ReadValue(readValue) && ...); }, readValues) && IsAtEnd() };
+            if (isRead)
+            {
+                std::tie(values...) = std::move(readValues);
+            }
+
+            return isRead;
+        }
+
+        [[nodiscard]] bool IsAtEnd() const
+        {
+            return mOffset == mData.size();
+        }
+
+    private:
+        [[nodiscard]] bool ReadBytes(void* destination, size_t size)
+        {
+            if (mData.size() - mOffset < size)
+            {
+                return false;
+            }
+
+            std::memcpy(destination, mData.data() + mOffset, size);
+            mOffset += size;
+            return true;
+        }
+
+        // a corrupted size can't make us allocate more than the data could possibly hold
+        [[nodiscard]] bool ReadSize(uint64_t& size, size_t minimumElementSize)
+        {
+            return ReadValue(size) && size <= (mData.size() - mOffset) / minimumElementSize;
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] bool ReadValue(T& value)
+        {
+            return ReadBytes(&value, sizeof(T));
+        }
+
+        template<typename T, typename U>
+        [[nodiscard]] bool ReadValue(std::pair<T, U>& value)
+        {
+            return ReadValue(value.first) && ReadValue(value.second);
+        }
+
+        template<typename T>
+        [[nodiscard]] bool ReadValue(std::vector<T>& values)
+        {
+            uint64_t size{};
+            if (!ReadSize(size, std::is_trivially_copyable_v<T> ? sizeof(T) : 1))
+            {
+                return false;
+            }
+
+            values.resize(size);
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                return ReadBytes(values.data(), size * sizeof(T));
+            }
+            else
+            {
+                return std::ranges::all_of(values, [this](T& value) { return ReadValue(value); });
+            }
+        }
+
+        // the cell count follows from the size, FromCells rejects sizes that don't fit together
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] bool ReadValue(Grid<T>& grid)
+        {
+            typename Grid<T>::PositionType rowCount{};
+            typename Grid<T>::PositionType columnCount{};
+            typename Grid<T>::PositionType border{};
+            if (!ReadValue(rowCount) || !ReadValue(columnCount) || !ReadValue(border) || rowCount < 0 || columnCount < 0 || border < 0)
+            {
+                return false;
+            }
+
+            const auto cellCount{ static_cast<uint64_t>(rowCount + 2 * border) * static_cast<uint64_t>(columnCount + 2 * border) };
+            if (cellCount > (mData.size() - mOffset) / sizeof(T))
+            {
+                return false;
+            }
+
+            std::vector<T> cells(cellCount);
+            if (!ReadBytes(cells.data(), cellCount * sizeof(T)))
+            {
+                return false;
+            }
+
+            auto result{ Grid<T>::FromCells(rowCount, columnCount, border, std::move(cells)) };
+            if (!result)
+            {
+                return false;
+            }
+
+            grid = std::move(*result);
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool ReadValue(std::unordered_set<T>& values)
+        {
+            uint64_t size{};
+            if (!ReadSize(size, 1))
+            {
+                return false;
+            }
+
+            values.reserve(size);
+            for (uint64_t index = 0; index < size; index++)
+            {
+                T value{};
+                if (!ReadValue(value))
+                {
+                    return false;
+                }
+                values.insert(std::move(value));
+            }
+            return true;
+        }
+
+        template<typename T, typename U>
+        [[nodiscard]] bool ReadValue(std::unordered_map<T, U>& values)
+        {
+            uint64_t size{};
+            if (!ReadSize(size, 1))
+            {
+                return false;
+            }
+
+            values.reserve(size);
+            for (uint64_t index = 0; index < size; index++)
+            {
+                T key{};
+                U value{};
+                if (!ReadValue(key) || !ReadValue(value))
+                {
+                    return false;
+                }
+                values.insert_or_assign(std::move(key), std::move(value));
+            }
+            return true;
+        }
+
+        std::string_view mData;
+        size_t mOffset{ 0 };
+    };
+
+    // Parsed input of one day, stored next to the others under the input version and the content hash of the input it came from.
+    // The version is part of the key as some days parse the same text differently for test inputs.
+    // A changed input gets a new file, a changed payload layout is told apart by the day's version.
+    class ParseCache
+    {
+    public:
+        ParseCache(std::filesystem::path directory, std::string_view day, InputVersion inputVersion, std::filesystem::path inputPath, uint32_t dayVersion)
+            : mDirectory{ std::move(directory) }
+            , mDay{ day }
+            , mInputVersion{ inputVersion }
+            , mInputPath{ std::move(inputPath) }
+            , mDayVersion{ dayVersion }
+        {
+        }
+
+        // Returns the cached payload, if there's one for the current content of the input.
+        // The view stays valid until the next Load or until the cache is destroyed.
+        [[nodiscard]] std::optional<std::string_view> Load()
+        {
+            const auto contentHash{ HashInput() };
+            if (!contentHash)
+            {
+                return {};
+            }
+
+            std::error_code errorCode;
+            const auto cachePath{ GetCachePath(*contentHash) };
+            if (!std::filesystem::is_regular_file(cachePath, errorCode))
+            {
+                return {};
+            }
+
+            mCacheFile = MappedFile{ cachePath };
+            const auto view{ mCacheFile.GetView() };
+            Header header{};
+            if (view.size() < sizeof(Header))
+            {
+                return {};
+            }
+            std::memcpy(&header, view.data(), sizeof(Header));
+
+            const auto payload{ view.substr(sizeof(Header)) };
+            if (header.mMagic != sParseCacheMagic || header.mFormatVersion != sParseCacheFormatVersion || header.mDayVersion != mDayVersion
+                || header.mContentHash != *contentHash || header.mPayloadSize != payload.size() || header.mPayloadHash != HashFnv1a(payload))
+            {
+                return {};
+            }
+
+            return payload;
+        }
+
+        // Written to a temporary file first and renamed, concurrent runs never see half a cache file.
+        void Store(std::string_view payload)
+        {
+            const auto contentHash{ HashInput() };
+            if (!contentHash)
+            {
+                return;
+            }
+
+            Header header{ sParseCacheMagic, sParseCacheFormatVersion, mDayVersion, *contentHash, payload.size(), HashFnv1a(payload) };
+            std::error_code errorCode;
+            std::filesystem::create_directories(mDirectory, errorCode);
+            const auto cachePath{ GetCachePath(*contentHash) };
+            auto temporaryPath{ cachePath };
+            temporaryPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+            {
+                std::ofstream outStream{ temporaryPath, std::ios::binary };
+                outStream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+                outStream.write(payload.data(), payload.size());
+                if (!outStream)
+                {
+                    std::filesystem::remove(temporaryPath, errorCode);
+                    return;
+                }
+            }
+            std::filesystem::rename(temporaryPath, cachePath, errorCode);
+        }
+
+    private:
+        struct Header
+        {
+            std::array<char, 8> mMagic;
+            uint32_t mFormatVersion;
+            uint32_t mDayVersion;
+            uint64_t mContentHash;
+            uint64_t mPayloadSize;
+            uint64_t mPayloadHash;
+        };
+
+        [[nodiscard]] std::optional<uint64_t> HashInput() const
+        {
+            std::error_code errorCode;
+            if (!std::filesystem::is_regular_file(mInputPath, errorCode))
+            {
+                return {};
+            }
+
+            const MappedFile input{ mInputPath };
+            return HashFnv1a(input.GetView());
+        }
+
+        [[nodiscard]] std::filesystem::path GetCachePath(uint64_t contentHash) const
+        {
+            std::array<char, 16> hexadecimal;
+            hexadecimal.fill('0');
+            std::array<char, 16> digits{};
+            const auto [end, _] {std::to_chars(digits.data(), digits.data() + digits.size(), contentHash, 16)};
+            std::copy(digits.data(), end, hexadecimal.end() - (end - digits.data()));
+            return mDirectory / std::string{ mDay }.append("_").append(sInputVersionStringMap.at(mInputVersion)).append("_").append(hexadecimal.data(), hexadecimal.size()).append(".bin");
+        }
+
+        std::filesystem::path mDirectory;
+        std::string_view mDay;
+        InputVersion mInputVersion;
+        std::filesystem::path mInputPath;
+        uint32_t mDayVersion;
+        MappedFile mCacheFile;
+    };
+}
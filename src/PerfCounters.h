@@ -0,0 +1,414 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utility
+{
+    enum class HardwareCounter
+    {
+        cycles,
+        instructions,
+        l1DataMisses,
+        lastLevelCacheMisses,
+        branchMisses,
+        dataTlbMisses,
+    };
+
+    static constexpr std::array<HardwareCounter, 6> sHardwareCounterOrder{ HardwareCounter::cycles, HardwareCounter::instructions,
+        HardwareCounter::l1DataMisses, HardwareCounter::lastLevelCacheMisses, HardwareCounter::branchMisses, HardwareCounter::dataTlbMisses };
+
+    static const std::unordered_map<HardwareCounter, std::string_view> sHardwareCounterStringMap
+    {
+        {HardwareCounter::cycles, "cycles"},
+        {HardwareCounter::instructions, "instructions"},
+        {HardwareCounter::l1DataMisses, "l1d_misses"},
+        {HardwareCounter::lastLevelCacheMisses, "llc_misses"},
+        {HardwareCounter::branchMisses, "branch_misses"},
+        {HardwareCounter::dataTlbMisses, "dtlb_misses"},
+    };
+
+    [[nodiscard]] constexpr size_t GetHardwareCounterIndex(HardwareCounter counter)
+    {
+        return static_cast<size_t>(counter);
+    }
+
+    // What a measured region cost besides wall time. Hardware counters are missing when they couldn't be opened,
+    // context switches when the platform doesn't report them.
+    struct CounterValues
+    {
+        std::array<std::optional<double>, sHardwareCounterOrder.size()> mHardware;
+        Duration mUserTime{};
+        Duration mSystemTime{};
+        std::optional<double> mVoluntaryContextSwitches;
+        std::optional<double> mInvoluntaryContextSwitches;
+
+        [[nodiscard]] std::optional<double> Get(HardwareCounter counter) const
+        {
+            return mHardware[GetHardwareCounterIndex(counter)];
+        }
+
+        [[nodiscard]] std::optional<double> GetInstructionsPerCycle() const
+        {
+            const auto cycles{ Get(HardwareCounter::cycles) };
+            const auto instructions{ Get(HardwareCounter::instructions) };
+            if (!cycles || !instructions || *cycles == 0.0)
+            {
+                return {};
+            }
+
+            return *instructions / *cycles;
+        }
+    };
+
+    // Mean per sample, a counter missing in any sample is missing in the result.
+    [[nodiscard]] CounterValues AverageCounterValues(std::span<const CounterValues> samples)
+    {
+        CounterValues result;
+        if (samples.empty())
+        {
+            return result;
+        }
+
+        const auto averageOptional = [&samples](auto member) -> std::optional<double>
+            {
+                double sum{};
+                for (const auto& sample : samples)
+                {
+                    const auto& value{ member(sample) };
+                    if (!value)
+                    {
+                        return {};
+                    }
+                    sum += *value;
+                }
+                return sum / samples.size();
+            };
+
+        for (const auto counter : sHardwareCounterOrder)
+        {
+            result.mHardware[GetHardwareCounterIndex(counter)] = averageOptional([counter](const CounterValues& sample) { return sample.Get(counter); });
+        }
+        result.mVoluntaryContextSwitches = averageOptional([](const CounterValues& sample) { return sample.mVoluntaryContextSwitches; });
+        result.mInvoluntaryContextSwitches = averageOptional([](const CounterValues& sample) { return sample.mInvoluntaryContextSwitches; });
+
+        Duration userTime{};
+        Duration systemTime{};
+        for (const auto& sample : samples)
+        {
+            userTime += sample.mUserTime;
+            systemTime += sample.mSystemTime;
+        }
+        result.mUserTime = userTime / samples.size();
+        result.mSystemTime = systemTime / samples.size();
+        return result;
+    }
+
+    // Hardware counters through perf_event_open on Linux, CPU time and context switches through getrusage.
+    // Counters that can't be opened (no PMU in a VM, perf_event_paranoid, other platforms) are left out, the rest still counts.
+    // The hardware counters are opened for the calling thread and for every worker of the thread pool, a phase is the sum over them,
+    // so the parts that hand their work to the pool are counted in full. Idle workers sleep, they add next to nothing.
+    // A counter that can't be opened for one of the threads is left out, a partial count would look like a real one.
+    class PerformanceCounters
+    {
+    public:
+        PerformanceCounters()
+        {
+#ifdef __linux__
+            std::vector<int64_t> threadIds{ 0 };    // 0 is the calling thread
+            const auto workerThreadIds{ GetThreadPool().GetWorkerThreadIds() };
+            threadIds.insert(threadIds.end(), workerThreadIds.begin(), workerThreadIds.end());
+            for (const auto threadId : threadIds)
+            {
+                auto& fileDescriptors{ mFileDescriptors.emplace_back() };
+                for (const auto counter : sHardwareCounterOrder)
+                {
+                    fileDescriptors[GetHardwareCounterIndex(counter)] = threadId != -1 ? Open(counter, threadId) : -1;
+                }
+            }
+#endif
+        }
+
+        ~PerformanceCounters()
+        {
+#ifdef __linux__
+            ForEachFileDescriptor([](int fileDescriptor) { close(fileDescriptor); });
+#endif
+        }
+
+        PerformanceCounters(const PerformanceCounters&) = delete;
+        PerformanceCounters& operator=(const PerformanceCounters&) = delete;
+
+        [[nodiscard]] bool HasHardwareCounters() const
+        {
+            bool result{ false };
+            ForEachFileDescriptor([&result](int) { result = true; });
+            return result;
+        }
+
+        void Start()
+        {
+            mStartUsage = GetUsage();
+#ifdef __linux__
+            ForEachFileDescriptor([](int fileDescriptor)
+                {
+                    ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+                });
+#endif
+        }
+
+        [[nodiscard]] CounterValues Stop()
+        {
+            CounterValues result;
+#ifdef __linux__
+            ForEachFileDescriptor([](int fileDescriptor) { ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0); });
+
+            for (const auto counter : sHardwareCounterOrder)
+            {
+                std::optional<double> sum{ 0.0 };
+                for (const auto& fileDescriptors : mFileDescriptors)
+                {
+                    const auto value{ Read(fileDescriptors[GetHardwareCounterIndex(counter)]) };
+                    if (!value)
+                    {
+                        sum.reset();
+                        break;
+                    }
+                    *sum += *value;
+                }
+                result.mHardware[GetHardwareCounterIndex(counter)] = mFileDescriptors.empty() ? std::nullopt : sum;
+            }
+#endif
+            const auto endUsage{ GetUsage() };
+            result.mUserTime = endUsage.mUserTime - mStartUsage.mUserTime;
+            result.mSystemTime = endUsage.mSystemTime - mStartUsage.mSystemTime;
+            if (endUsage.mVoluntaryContextSwitches && mStartUsage.mVoluntaryContextSwitches)
+            {
+                result.mVoluntaryContextSwitches = static_cast<double>(*endUsage.mVoluntaryContextSwitches - *mStartUsage.mVoluntaryContextSwitches);
+                result.mInvoluntaryContextSwitches = static_cast<double>(*endUsage.mInvoluntaryContextSwitches - *mStartUsage.mInvoluntaryContextSwitches);
+            }
+            return result;
+        }
+
+    private:
+        using FileDescriptors = std::array<int, sHardwareCounterOrder.size()>;
+
+        template<typename Function>
+        void ForEachFileDescriptor(Function&& function) const
+        {
+            for (const auto& fileDescriptors : mFileDescriptors)
+            {
+                for (const auto fileDescriptor : fileDescriptors)
+                {
+                    if (fileDescriptor != -1)
+                    {
+                        function(fileDescriptor);
+                    }
+                }
+            }
+        }
+
+        struct Usage
+        {
+            Duration mUserTime{};
+            Duration mSystemTime{};
+            std::optional<int64_t> mVoluntaryContextSwitches;
+            std::optional<int64_t> mInvoluntaryContextSwitches;
+        };
+
+        [[nodiscard]] static Usage GetUsage()
+        {
+            Usage result;
+#ifdef _WIN32
+            FILETIME creationTime{};
+            FILETIME exitTime{};
+            FILETIME kernelTime{};
+            FILETIME userTime{};
+            if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+            {
+                // FILETIME counts 100 ns ticks
+                const auto toDuration = [](FILETIME time) { return Duration{ ((static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 100 }; };
+                result.mUserTime = toDuration(userTime);
+                result.mSystemTime = toDuration(kernelTime);
+            }
+#else
+            rusage usage{};
+            if (getrusage(RUSAGE_SELF, &usage) == 0)
+            {
+                const auto toDuration = [](timeval time) { return std::chrono::seconds{ time.tv_sec } + std::chrono::microseconds{ time.tv_usec }; };
+                result.mUserTime = toDuration(usage.ru_utime);
+                result.mSystemTime = toDuration(usage.ru_stime);
+                result.mVoluntaryContextSwitches = usage.ru_nvcsw;
+                result.mInvoluntaryContextSwitches = usage.ru_nivcsw;
+            }
+#endif
+            return result;
+        }
+
+#ifdef __linux__
+        // threadId 0 is the calling thread
+        [[nodiscard]] static int Open(HardwareCounter counter, int64_t threadId)
+        {
+            const auto cacheMiss = [](uint64_t cache) { return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16); };
+
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            switch (counter)
+            {
+            case HardwareCounter::cycles:
+            {
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            }
+            break;
+            case HardwareCounter::instructions:
+            {
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            }
+            break;
+            case HardwareCounter::l1DataMisses:
+            {
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_L1D);
+            }
+            break;
+            case HardwareCounter::lastLevelCacheMisses:
+            {
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_LL);
+            }
+            break;
+            case HardwareCounter::branchMisses:
+            {
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            }
+            break;
+            case HardwareCounter::dataTlbMisses:
+            {
+                attributes.type = PERF_TYPE_HW_CACHE;
+                attributes.config = cacheMiss(PERF_COUNT_HW_CACHE_DTLB);
+            }
+            break;
+            }
+
+            // user space only, that is allowed with the default perf_event_paranoid setting
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, static_cast<pid_t>(threadId), -1, -1, 0));
+        }
+
+        // The kernel multiplexes when there are more counters than registers, the value is scaled up to the enabled time.
+        [[nodiscard]] static std::optional<double> Read(int fileDescriptor)
+        {
+            if (fileDescriptor == -1)
+            {
+                return {};
+            }
+
+            struct
+            {
+                uint64_t mValue;
+                uint64_t mTimeEnabled;
+                uint64_t mTimeRunning;
+            } readValue{};
+            if (read(fileDescriptor, &readValue, sizeof(readValue)) != sizeof(readValue))
+            {
+                return {};
+            }
+
+            // a thread that didn't run in the region has no enabled time, it counted nothing
+            if (readValue.mTimeEnabled == 0)
+            {
+                return 0.0;
+            }
+
+            if (readValue.mTimeRunning == 0)
+            {
+                return {};
+            }
+
+            return static_cast<double>(readValue.mValue) * readValue.mTimeEnabled / readValue.mTimeRunning;
+        }
+#endif
+
+        std::vector<FileDescriptors> mFileDescriptors;    // the calling thread first, then the workers of the pool
+        Usage mStartUsage;
+    };
+
+    void PrintCountersHeader(std::ostream& outStream)
+    {
+        outStream << std::left << std::setw(16) << "Phase" << std::right
+            << std::setw(14) << "cycles" << std::setw(14) << "instructions" << std::setw(8) << "IPC"
+            << std::setw(12) << "L1D miss" << std::setw(12) << "LLC miss" << std::setw(12) << "branch miss" << std::setw(12) << "dTLB miss"
+            << std::setw(12) << "user us" << std::setw(12) << "sys us" << std::setw(10) << "ctx sw" << "  (mean)\n";
+    }
+
+    void PrintCounters(std::ostream& outStream, Phase phase, const CounterValues& values)
+    {
+        const auto printOptional = [&outStream](int32_t width, std::optional<double> value, int32_t precision = 0)
+            {
+                outStream << std::setw(width);
+                if (value)
+                {
+                    outStream << std::fixed << std::setprecision(precision) << *value << std::defaultfloat;
+                }
+                else
+                {
+                    outStream << "n/a";
+                }
+            };
+
+        outStream << std::left << std::setw(16) << sPhaseStringMap.at(phase) << std::right;
+        printOptional(14, values.Get(HardwareCounter::cycles));
+        printOptional(14, values.Get(HardwareCounter::instructions));
+        printOptional(8, values.GetInstructionsPerCycle(), 2);
+        printOptional(12, values.Get(HardwareCounter::l1DataMisses));
+        printOptional(12, values.Get(HardwareCounter::lastLevelCacheMisses));
+        printOptional(12, values.Get(HardwareCounter::branchMisses));
+        printOptional(12, values.Get(HardwareCounter::dataTlbMisses));
+        outStream << std::setw(12) << std::chrono::duration_cast<std::chrono::microseconds>(values.mUserTime).count()
+            << std::setw(12) << std::chrono::duration_cast<std::chrono::microseconds>(values.mSystemTime).count();
+        std::optional<double> contextSwitches;
+        if (values.mVoluntaryContextSwitches && values.mInvoluntaryContextSwitches)
+        {
+            contextSwitches = *values.mVoluntaryContextSwitches + *values.mInvoluntaryContextSwitches;
+        }
+        printOptional(10, contextSwitches, 1);
+        outStream << '\n';
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "Utility.h"
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace utility
+{
+    // Answer of one part, days return whichever integer type they calculate in.
+    // monostate means the part has no answer, e.g. when it isn't implemented for the input.
+    using Result = std::variant<std::monostate, int64_t, uint64_t, std::string>;
+
+    struct PartResults
+    {
+        Result mFirst;
+        Result mSecond;
+    };
+
+    [[nodiscard]] bool HasValue(const Result& result)
+    {
+        return !std::holds_alternative<std::monostate>(result);
+    }
+
+    [[nodiscard]] std::string ToString(const Result& result)
+    {
+        return std::visit([](const auto& value) -> std::string
+            {
+                using ValueType = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<ValueType, std::monostate>)
+                {
+                    return "none";
+                }
+                else if constexpr (std::is_same_v<ValueType, std::string>)
+                {
+                    return value;
+                }
+                else
+                {
+                    return std::to_string(value);
+                }
+            }, result);
+    }
+
+    // Identifies an answer: day, input version and part names.
+    using AnswerKey = std::tuple<std::string, std::string, std::string>;
+    using ExpectedAnswers = std::map<AnswerKey, std::string>;
+
+    // Looked up next to the inputs unless a path is given.
+    static constexpr std::string_view sExpectedAnswersFileName{ "expected_answers.txt" };
+
+    [[nodiscard]] std::filesystem::path GetDefaultExpectedAnswersPath()
+    {
+        return (std::filesystem::path{ INPUT_DIR } / sExpectedAnswersFileName).make_preferred();
+    }
+
+    [[nodiscard]] AnswerKey GetAnswerKey(std::string_view day, InputVersion inputVersion, Part part)
+    {
+        return { std::string{ day }, std::string{ sInputVersionStringMap.at(inputVersion) }, std::string{ sPartStringMap.at(part) } };
+    }
+
+    // One answer per line: day,input version,part,answer, e.g. day1,Release,First,11.
+    // Empty lines and lines starting with # are skipped.
+    [[nodiscard]] std::expected<ExpectedAnswers, std::string> LoadExpectedAnswers(const std::filesystem::path& path)
+    {
+        std::ifstream inStream{ path };
+        if (!inStream)
+        {
+            return std::unexpected{ std::string{ "couldn't open expected answers " }.append(path.string()) };
+        }
+
+        using namespace std::literals;
+        ExpectedAnswers result;
+        std::string line;
+        while (std::getline(inStream, line))
+        {
+            if (line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+
+            std::vector<std::string_view> fields;
+            for (const auto field : line | std::ranges::views::split(","sv)
+                | std::ranges::views::transform([](auto&& range) {return std::string_view{ range }; }))
+            {
+                fields.push_back(field);
+            }
+
+            if (fields.size() != 4)
+            {
+                return std::unexpected{ std::string{ "malformed expected answer line: " }.append(line) };
+            }
+
+            result.insert_or_assign(AnswerKey{ fields[0], fields[1], fields[2] }, std::string{ fields[3] });
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] std::optional<std::string> FindExpectedAnswer(const ExpectedAnswers& expectedAnswers, std::string_view day, InputVersion inputVersion, Part part)
+    {
+        const auto answerIterator{ expectedAnswers.find(GetAnswerKey(day, inputVersion, part)) };
+        if (answerIterator == expectedAnswers.end())
+        {
+            return {};
+        }
+
+        return answerIterator->second;
+    }
+}
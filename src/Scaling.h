@@ -0,0 +1,207 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace utility
+{
+    // Synthetic inputs are generated at mMinimumSize, mMinimumSize * mFactor, ... for mSteps sizes.
+    // n log n fits an exponent of about 1.1 over a few doublings, so 1.2 separates it from n^1.5 and worse.
+    struct ScalingOptions
+    {
+        bool mEnabled{ false };
+        int32_t mMinimumSize{ 250 };
+        int32_t mSteps{ 5 };
+        double mFactor{ 2.0 };
+        double mSuperlinearExponent{ 1.2 };
+    };
+
+    [[nodiscard]] std::vector<size_t> GetScalingSizes(const ScalingOptions& options)
+    {
+        std::vector<size_t> result;
+        double size{ static_cast<double>(options.mMinimumSize) };
+        for (int32_t step = 0; step < options.mSteps; step++)
+        {
+            result.push_back(static_cast<size_t>(std::llround(size)));
+            size *= options.mFactor;
+        }
+
+        return result;
+    }
+
+    enum class ComplexityModel
+    {
+        constant,
+        logarithmic,
+        linear,
+        linearithmic,
+        quadratic,
+        cubic,
+    };
+
+    static constexpr std::array<ComplexityModel, 6> sComplexityModels{ ComplexityModel::constant, ComplexityModel::logarithmic, ComplexityModel::linear,
+        ComplexityModel::linearithmic, ComplexityModel::quadratic, ComplexityModel::cubic };
+
+    static const std::unordered_map<ComplexityModel, std::string_view> sComplexityModelStringMap
+    {
+        {ComplexityModel::constant, "O(1)"},
+        {ComplexityModel::logarithmic, "O(log n)"},
+        {ComplexityModel::linear, "O(n)"},
+        {ComplexityModel::linearithmic, "O(n log n)"},
+        {ComplexityModel::quadratic, "O(n^2)"},
+        {ComplexityModel::cubic, "O(n^3)"},
+    };
+
+    [[nodiscard]] double EvaluateComplexityModel(ComplexityModel model, double size)
+    {
+        switch (model)
+        {
+        case ComplexityModel::constant:
+        {
+            return 1.0;
+        }
+        case ComplexityModel::logarithmic:
+        {
+            return std::log2(size);
+        }
+        case ComplexityModel::linear:
+        {
+            return size;
+        }
+        case ComplexityModel::linearithmic:
+        {
+            return size * std::log2(size);
+        }
+        case ComplexityModel::quadratic:
+        {
+            return size * size;
+        }
+        case ComplexityModel::cubic:
+        {
+            return size * size * size;
+        }
+        }
+
+        assert(false);
+        return 1.0;
+    }
+
+    // Median time of one phase at one input size, the size is measured in input bytes.
+    struct ScalingPoint
+    {
+        double mSize;
+        Duration mMedian;
+    };
+
+    struct ScalingFit
+    {
+        double mExponent{};             // slope of the log-log least squares line
+        double mExponentRSquared{};
+        ComplexityModel mBestModel{ ComplexityModel::constant };
+        double mBestModelError{};       // root mean square of the relative residuals
+    };
+
+    // Fits time = size^exponent on a log-log scale and every complexity model as time = c * model(size).
+    // The models are fitted on relative residuals, otherwise the largest size would dominate the fit.
+    [[nodiscard]] ScalingFit FitScaling(std::span<const ScalingPoint> points)
+    {
+        ScalingFit result;
+        std::vector<ScalingPoint> usablePoints;
+        std::ranges::copy_if(points, std::back_inserter(usablePoints), [](const ScalingPoint& point) {return point.mSize > 1.0 && point.mMedian.count() > 0; });
+        if (usablePoints.size() < 2)
+        {
+            return result;
+        }
+
+        const double count{ static_cast<double>(usablePoints.size()) };
+        double sumX{}, sumY{}, sumXX{}, sumXY{}, sumYY{};
+        for (const auto& point : usablePoints)
+        {
+            const double x{ std::log(point.mSize) };
+            const double y{ std::log(static_cast<double>(point.mMedian.count())) };
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+            sumYY += y * y;
+        }
+
+        const double varianceX{ count * sumXX - sumX * sumX };
+        const double varianceY{ count * sumYY - sumY * sumY };
+        const double covariance{ count * sumXY - sumX * sumY };
+        if (varianceX > 0.0)
+        {
+            result.mExponent = covariance / varianceX;
+            result.mExponentRSquared = varianceY > 0.0 ? covariance * covariance / (varianceX * varianceY) : 1.0;
+        }
+
+        double bestError{ std::numeric_limits<double>::max() };
+        for (const auto model : sComplexityModels)
+        {
+            // least squares of (t - c * f) / t gives c = sum(f / t) / sum(f^2 / t^2)
+            double numerator{}, denominator{};
+            for (const auto& point : usablePoints)
+            {
+                const double ratio{ EvaluateComplexityModel(model, point.mSize) / static_cast<double>(point.mMedian.count()) };
+                numerator += ratio;
+                denominator += ratio * ratio;
+            }
+            const double factor{ numerator / denominator };
+
+            double squaredError{};
+            for (const auto& point : usablePoints)
+            {
+                const double time{ static_cast<double>(point.mMedian.count()) };
+                const double residual{ (time - factor * EvaluateComplexityModel(model, point.mSize)) / time };
+                squaredError += residual * residual;
+            }
+
+            const double error{ std::sqrt(squaredError / count) };
+            if (error < bestError)
+            {
+                bestError = error;
+                result.mBestModel = model;
+                result.mBestModelError = error;
+            }
+        }
+
+        return result;
+    }
+
+    void PrintScalingPoints(std::ostream& outStream, Phase phase, std::span<const ScalingPoint> points)
+    {
+        outStream << std::left << std::setw(16) << sPhaseStringMap.at(phase) << std::right;
+        for (const auto& point : points)
+        {
+            outStream << ' ' << static_cast<uintmax_t>(point.mSize) << "B:" << point.mMedian.count() << "ns";
+        }
+        outStream << '\n';
+    }
+
+    void PrintScalingFitHeader(std::ostream& outStream)
+    {
+        outStream << std::left << std::setw(16) << "Phase" << std::right << std::setw(10) << "exponent" << std::setw(8) << "r^2"
+            << "  " << std::left << std::setw(12) << "best fit" << std::right << std::setw(10) << "rms error" << "  verdict\n";
+    }
+
+    // Flags phases growing faster than the threshold exponent, those won't survive much larger inputs.
+    void PrintScalingFit(std::ostream& outStream, Phase phase, const ScalingFit& fit, const ScalingOptions& options)
+    {
+        const bool isSuperlinear{ fit.mExponent > options.mSuperlinearExponent };
+        outStream << std::left << std::setw(16) << sPhaseStringMap.at(phase) << std::right
+            << std::fixed << std::setprecision(2) << std::setw(10) << fit.mExponent << std::setw(8) << fit.mExponentRSquared
+            << "  " << std::left << std::setw(12) << sComplexityModelStringMap.at(fit.mBestModel) << std::right
+            << std::setw(10) << fit.mBestModelError << std::defaultfloat
+            << "  " << (isSuperlinear ? "SUPERLINEAR" : "ok") << '\n';
+    }
+}
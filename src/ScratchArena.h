@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace utility
+{
+    static constexpr size_t sDefaultScratchBufferSize{ 1 << 16 };
+
+    // Bump allocator for data that only lives during a part. Allocations are served from the buffer first
+    // and from the heap once it's used up, deallocations are no-ops and Release frees everything at once.
+    // The buffer is kept over releases, so a reused arena doesn't touch the heap until it outgrows it.
+    // Not thread safe, work on the thread pool uses ThreadScratchScope instead.
+    class ScratchArena
+    {
+    public:
+        explicit ScratchArena(size_t bufferSize = sDefaultScratchBufferSize)
+            : mBuffer{ bufferSize > 0 ? std::make_unique_for_overwrite<std::byte[]>(bufferSize) : nullptr }
+            , mResource{ mBuffer ? std::pmr::monotonic_buffer_resource{ mBuffer.get(), bufferSize, std::pmr::new_delete_resource() }
+                : std::pmr::monotonic_buffer_resource{ std::pmr::new_delete_resource() } }
+        {
+        }
+
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* GetResource()
+        {
+            return &mResource;
+        }
+
+        // Every container allocated from the arena has to be gone by now.
+        void Release()
+        {
+            mResource.release();
+        }
+
+    private:
+        std::unique_ptr<std::byte[]> mBuffer;
+        std::pmr::monotonic_buffer_resource mResource;
+    };
+
+    // Scratch arena of the calling thread, for tasks on the thread pool. It's released when the outermost scope
+    // on the thread ends, scopes nest when a task waiting on a group runs other tasks in the meantime.
+    class ThreadScratchScope
+    {
+    public:
+        ThreadScratchScope()
+        {
+            ++sDepth;
+        }
+
+        ~ThreadScratchScope()
+        {
+            if (--sDepth == 0)
+            {
+                GetArena().Release();
+            }
+        }
+
+        ThreadScratchScope(const ThreadScratchScope&) = delete;
+        ThreadScratchScope& operator=(const ThreadScratchScope&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* GetResource()
+        {
+            return GetArena().GetResource();
+        }
+
+    private:
+        [[nodiscard]] static ScratchArena& GetArena()
+        {
+            static thread_local ScratchArena sArena;
+            return sArena;
+        }
+
+        static inline thread_local size_t sDepth{ 0 };
+    };
+}
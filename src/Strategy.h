@@ -0,0 +1,56 @@
+#pragma once
+#include "Utility.h"
+#include "Benchmark.h"
+#include "Result.h"
+
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace utility
+{
+    // One implementation of a part. Days list theirs in a static GetStrategies(Part), the first one is the reference,
+    // which is what PerformFirst or PerformSecond runs. Every strategy only reads the parsed input.
+    template<typename Day>
+    struct Strategy
+    {
+        std::string_view mName;
+        Result(Day::* mPerform)();
+    };
+
+    struct StrategyResult
+    {
+        std::string_view mName;
+        TimingStatistics mStatistics;
+        std::string mAnswer;
+        bool mIsMatchingReference{};
+    };
+
+    void PrintStrategyComparison(std::ostream& outStream, InputVersion version, Part part, std::span<const StrategyResult> results)
+    {
+        outStream << "[Version]: " << sInputVersionStringMap.at(version) << " [Part]: " << sPartStringMap.at(part) << '\n'
+            << std::left << std::setw(20) << "Strategy" << std::right << std::setw(14) << "min" << std::setw(14) << "median"
+            << std::setw(14) << "speedup" << "  answer  (ns, speedup of the median over the reference)\n";
+        if (results.empty())
+        {
+            return;
+        }
+
+        const auto referenceMedian{ static_cast<double>(results.front().mStatistics.mMedian.count()) };
+        for (const auto& result : results)
+        {
+            const auto median{ static_cast<double>(result.mStatistics.mMedian.count()) };
+            outStream << std::left << std::setw(20) << result.mName << std::right
+                << std::setw(14) << result.mStatistics.mMinimum.count() << std::setw(14) << result.mStatistics.mMedian.count()
+                << std::setw(13) << std::fixed << std::setprecision(2) << (median > 0.0 ? referenceMedian / median : 0.0) << 'x' << std::defaultfloat
+                << "  " << result.mAnswer;
+            if (!result.mIsMatchingReference)
+            {
+                outStream << "\033[1;31m" << " differs from the reference" << "\033[0m";
+            }
+            outStream << '\n';
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utility
+{
+    static constexpr size_t sDefaultChunkSize{ 1 << 20 };
+
+    // Where a day reads its input from, unless overridden the path follows from INPUT_DIR and the InputVersion.
+    struct InputSource
+    {
+        std::filesystem::path mPath;
+        bool mIsStandardInput{ false };
+        bool mIsStreaming{ false };     // line oriented days parse chunk by chunk instead of holding the whole input
+        size_t mChunkSize{ sDefaultChunkSize };
+
+        [[nodiscard]] bool IsOverridden() const
+        {
+            return mIsStandardInput || !mPath.empty();
+        }
+    };
+
+    // Reads a stream in chunks of roughly the chunk size that only ever contain complete records.
+    // A record cut off at the end of a chunk is carried over to the next one, so memory stays bounded by
+    // the chunk size plus the longest record.
+    class ChunkedReader
+    {
+    public:
+        ChunkedReader(std::istream& inStream, std::string_view delimiter = "\n", size_t chunkSize = sDefaultChunkSize)
+            : mInStream{ inStream }
+            , mDelimiter{ delimiter }
+            , mChunkSize{ chunkSize == 0 ? sDefaultChunkSize : chunkSize }
+        {
+        }
+
+        // Returns the next chunk of records including their delimiters, the last chunk may end without one.
+        // The view is valid until the next call.
+        [[nodiscard]] std::optional<std::string_view> NextChunk()
+        {
+            mBuffer.erase(0, mConsumed);
+            mConsumed = 0;
+            while (!mIsExhausted)
+            {
+                const auto previousSize{ mBuffer.size() };
+                mBuffer.resize(previousSize + mChunkSize);
+                mInStream.read(mBuffer.data() + previousSize, static_cast<std::streamsize>(mChunkSize));
+                mBuffer.resize(previousSize + static_cast<size_t>(mInStream.gcount()));
+                if (!mInStream)
+                {
+                    mIsExhausted = true;
+                    break;
+                }
+
+                // the carried over part never holds a delimiter, so any match completes a record
+                if (const auto lastDelimiter{ mBuffer.rfind(mDelimiter) }; lastDelimiter != std::string::npos)
+                {
+                    mConsumed = lastDelimiter + mDelimiter.size();
+                    return std::string_view{ mBuffer }.substr(0, mConsumed);
+                }
+            }
+
+            if (mBuffer.empty())
+            {
+                return {};
+            }
+
+            mConsumed = mBuffer.size();
+            return std::string_view{ mBuffer };
+        }
+
+        // Calls the callback with every record, without its delimiter.
+        template<typename Callback>
+        void ForEachRecord(Callback&& callback)
+        {
+            while (const auto chunk{ NextChunk() })
+            {
+                size_t recordStart{ 0 };
+                while (recordStart < chunk->size())
+                {
+                    const auto recordEnd{ chunk->find(mDelimiter, recordStart) };
+                    if (recordEnd == std::string_view::npos)
+                    {
+                        callback(chunk->substr(recordStart));
+                        break;
+                    }
+
+                    callback(chunk->substr(recordStart, recordEnd - recordStart));
+                    recordStart = recordEnd + mDelimiter.size();
+                }
+            }
+        }
+
+    private:
+        std::istream& mInStream;
+        std::string mDelimiter;
+        size_t mChunkSize;
+        std::string mBuffer;
+        size_t mConsumed{ 0 };
+        bool mIsExhausted{ false };
+    };
+}
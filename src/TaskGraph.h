@@ -0,0 +1,95 @@
+#pragma once
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace utility
+{
+    // Tasks with dependencies, a task goes to the pool once everything it depends on is done.
+    // A node can only depend on nodes added before it, so the graph can't have cycles.
+    // If a task throws, the tasks depending on it don't run and Run rethrows the first exception.
+    class TaskGraph
+    {
+    public:
+        using NodeId = size_t;
+        using Task = std::function<void()>;
+
+        explicit TaskGraph(ThreadPool& threadPool = GetThreadPool()) : mThreadPool{ threadPool } {}
+
+        NodeId AddNode(Task task, std::span<const NodeId> dependencies = {})
+        {
+            const NodeId result{ mNodes.size() };
+            for (const auto dependency : dependencies)
+            {
+                assert(dependency < result);
+                mNodes[dependency].mDependents.push_back(result);
+            }
+            mNodes.emplace_back(std::move(task), std::vector<NodeId>{}, dependencies.size());
+            return result;
+        }
+
+        NodeId AddNode(Task task, std::initializer_list<NodeId> dependencies)
+        {
+            return AddNode(std::move(task), std::span<const NodeId>{ dependencies.begin(), dependencies.size() });
+        }
+
+        [[nodiscard]] size_t GetNodeCount() const
+        {
+            return mNodes.size();
+        }
+
+        // Runs every node and waits for them, helping out on the pool in the meantime.
+        void Run()
+        {
+            mPendingDependencyCounts = std::make_unique<std::atomic<size_t>[]>(mNodes.size());
+            for (NodeId node = 0; node < mNodes.size(); node++)
+            {
+                mPendingDependencyCounts[node].store(mNodes[node].mDependencyCount, std::memory_order_relaxed);
+            }
+
+            TaskGroup taskGroup{ mThreadPool };
+            for (NodeId node = 0; node < mNodes.size(); node++)
+            {
+                if (mNodes[node].mDependencyCount == 0)
+                {
+                    Schedule(taskGroup, node);
+                }
+            }
+            taskGroup.Wait();
+        }
+
+    private:
+        struct Node
+        {
+            Task mTask;
+            std::vector<NodeId> mDependents;
+            size_t mDependencyCount;
+        };
+
+        // the group only runs out of pending tasks once the last node released its dependents
+        void Schedule(TaskGroup& taskGroup, NodeId node)
+        {
+            taskGroup.Run([this, &taskGroup, node]
+                {
+                    mNodes[node].mTask();
+                    for (const auto dependent : mNodes[node].mDependents)
+                    {
+                        if (mPendingDependencyCounts[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            Schedule(taskGroup, dependent);
+                        }
+                    }
+                });
+        }
+
+        ThreadPool& mThreadPool;
+        std::vector<Node> mNodes;
+        std::unique_ptr<std::atomic<size_t>[]> mPendingDependencyCounts;
+    };
+}
@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utility
+{
+    // The kernel's id of the calling thread, -1 on the platforms that have no use for it.
+    [[nodiscard]] inline int64_t GetCurrentThreadOsId()
+    {
+#ifdef __linux__
+        return static_cast<int64_t>(syscall(SYS_gettid));
+#else
+        return -1;
+#endif
+    }
+
+    // Work stealing pool, every worker owns a deque it pushes to and pops from at the back,
+    // idle workers steal from the front of the others. Tasks submitted from outside are spread round robin.
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        explicit ThreadPool(size_t threadCount)
+        {
+            threadCount = std::max<size_t>(threadCount, 1);
+            mQueues.reserve(threadCount);
+            for (size_t index = 0; index < threadCount; index++)
+            {
+                mQueues.push_back(std::make_unique<WorkerQueue>());
+            }
+
+            // the workers report their ids before the pool is handed out
+            mWorkerThreadIds.resize(threadCount, -1);
+            std::latch startedWorkers{ static_cast<ptrdiff_t>(threadCount) };
+            mWorkers.reserve(threadCount);
+            for (size_t index = 0; index < threadCount; index++)
+            {
+                mWorkers.emplace_back([this, index, &startedWorkers]
+                    {
+                        mWorkerThreadIds[index] = GetCurrentThreadOsId();
+                        startedWorkers.count_down();
+                        WorkerLoop(index);
+                    });
+            }
+            startedWorkers.wait();
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::unique_lock<std::mutex> lock{ mSleepMutex };
+                mIsStopping = true;
+            }
+            mWakeUp.notify_all();
+            std::ranges::for_each(mWorkers, &std::thread::join);
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] size_t GetThreadCount() const
+        {
+            return mWorkers.size();
+        }
+
+        // See GetCurrentThreadOsId, the performance counters follow the workers by these.
+        [[nodiscard]] std::span<const int64_t> GetWorkerThreadIds() const
+        {
+            return mWorkerThreadIds;
+        }
+
+        void Submit(Task task)
+        {
+            const auto queueIndex{ sCurrentPool == this ? sWorkerIndex : mNextQueueIndex.fetch_add(1, std::memory_order_relaxed) % mQueues.size() };
+            {
+                auto& queue{ *mQueues[queueIndex] };
+                std::unique_lock<std::mutex> lock{ queue.mMutex };
+                queue.mTasks.push_back(std::move(task));
+            }
+            mPendingTaskCount.fetch_add(1, std::memory_order_release);
+
+            // taking the lock orders this with a worker that's about to sleep, so the notification isn't lost
+            {
+                std::unique_lock<std::mutex> lock{ mSleepMutex };
+            }
+            mWakeUp.notify_one();
+        }
+
+        // Runs one pending task on the calling thread, returns false if there was none.
+        // Waiting threads call this, so they help instead of blocking a worker.
+        bool TryRunTask()
+        {
+            auto task{ TakeTask(sCurrentPool == this ? sWorkerIndex : 0) };
+            if (!task)
+            {
+                return false;
+            }
+
+            (*task)();
+            return true;
+        }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mMutex;
+            std::deque<Task> mTasks;
+        };
+
+        [[nodiscard]] std::optional<Task> TakeTask(size_t ownQueueIndex)
+        {
+            if (mPendingTaskCount.load(std::memory_order_acquire) == 0)
+            {
+                return {};
+            }
+
+            // own queue from the back, it's the most recently pushed and likely still in cache
+            {
+                auto& queue{ *mQueues[ownQueueIndex] };
+                std::unique_lock<std::mutex> lock{ queue.mMutex };
+                if (!queue.mTasks.empty())
+                {
+                    auto task{ std::move(queue.mTasks.back()) };
+                    queue.mTasks.pop_back();
+                    mPendingTaskCount.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+
+            for (size_t offset = 1; offset < mQueues.size(); offset++)
+            {
+                auto& queue{ *mQueues[(ownQueueIndex + offset) % mQueues.size()] };
+                std::unique_lock<std::mutex> lock{ queue.mMutex };
+                if (!queue.mTasks.empty())
+                {
+                    auto task{ std::move(queue.mTasks.front()) };
+                    queue.mTasks.pop_front();
+                    mPendingTaskCount.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+
+            return {};
+        }
+
+        void WorkerLoop(size_t workerIndex)
+        {
+            sCurrentPool = this;
+            sWorkerIndex = workerIndex;
+            while (true)
+            {
+                if (auto task{ TakeTask(workerIndex) })
+                {
+                    (*task)();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{ mSleepMutex };
+                mWakeUp.wait(lock, [this] { return mIsStopping || mPendingTaskCount.load(std::memory_order_acquire) > 0; });
+                if (mIsStopping)
+                {
+                    return;
+                }
+            }
+        }
+
+        static inline thread_local ThreadPool* sCurrentPool{ nullptr };
+        static inline thread_local size_t sWorkerIndex{ 0 };
+
+        std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+        std::vector<std::thread> mWorkers;
+        std::vector<int64_t> mWorkerThreadIds;
+        std::atomic<size_t> mPendingTaskCount{ 0 };
+        std::atomic<size_t> mNextQueueIndex{ 0 };
+        std::mutex mSleepMutex;
+        std::condition_variable mWakeUp;
+        bool mIsStopping{ false };
+    };
+
+    // Shared by every day, one thread less than the hardware has, as the waiting thread helps out.
+    [[nodiscard]] ThreadPool& GetThreadPool()
+    {
+        static ThreadPool sThreadPool{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+        return sThreadPool;
+    }
+
+    // Tasks that are waited for together. Wait runs pending tasks while waiting, so groups can nest.
+    // The first exception thrown by a task is rethrown from Wait.
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool& threadPool = GetThreadPool()) : mThreadPool{ threadPool } {}
+
+        ~TaskGroup()
+        {
+            WaitForTasks();
+        }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template<typename Function>
+        void Run(Function&& function)
+        {
+            mPendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+            mThreadPool.Submit([this, function = std::forward<Function>(function)]() mutable
+                {
+                    try
+                    {
+                        function();
+                    }
+                    catch (...)
+                    {
+                        std::unique_lock<std::mutex> lock{ mExceptionMutex };
+                        if (!mException)
+                        {
+                            mException = std::current_exception();
+                        }
+                    }
+                    mPendingTaskCount.fetch_sub(1, std::memory_order_release);
+                });
+        }
+
+        void Wait()
+        {
+            WaitForTasks();
+            if (mException)
+            {
+                std::rethrow_exception(std::exchange(mException, nullptr));
+            }
+        }
+
+    private:
+        void WaitForTasks()
+        {
+            while (mPendingTaskCount.load(std::memory_order_acquire) > 0)
+            {
+                if (!mThreadPool.TryRunTask())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        ThreadPool& mThreadPool;
+        std::atomic<size_t> mPendingTaskCount{ 0 };
+        std::mutex mExceptionMutex;
+        std::exception_ptr mException;
+    };
+
+    // Calls function(index) for every index in [begin, end) on the pool.
+    // Without a grain size the range is cut into about four chunks per thread to balance uneven work.
+    template<typename Function>
+    void ParallelFor(size_t begin, size_t end, Function&& function, size_t grainSize = 0, ThreadPool& threadPool = GetThreadPool())
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        if (grainSize == 0)
+        {
+            grainSize = std::max<size_t>((end - begin) / ((threadPool.GetThreadCount() + 1) * 4), 1);
+        }
+
+        TaskGroup taskGroup{ threadPool };
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+        {
+            const auto chunkEnd{ std::min(chunkBegin + grainSize, end) };
+            taskGroup.Run([&function, chunkBegin, chunkEnd]
+                {
+                    for (size_t index = chunkBegin; index < chunkEnd; index++)
+                    {
+                        function(index);
+                    }
+                });
+        }
+        taskGroup.Wait();
+    }
+}
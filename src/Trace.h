@@ -0,0 +1,158 @@
+#pragma once
+#include "BenchmarkReport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace utility
+{
+    namespace trace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Zone
+        {
+            std::string_view mName;
+            std::string_view mCategory;
+            Clock::time_point mStart;
+            Clock::time_point mEnd;
+        };
+
+        // Only written by its own thread and only read once tracing stopped, so it needs no lock.
+        // The buffers belong to the registry, they outlive the threads that wrote them.
+        struct ThreadBuffer
+        {
+            std::thread::id mThreadId;
+            std::vector<Zone> mZones;
+        };
+
+        struct Registry
+        {
+            std::mutex mMutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+            std::thread::id mMainThreadId;
+            Clock::time_point mStart;
+        };
+
+        // a relaxed load is all a zone costs while tracing is off
+        static constinit std::atomic<bool> sIsEnabled{ false };
+
+        [[nodiscard]] Registry& GetRegistry()
+        {
+            static Registry sRegistry;
+            return sRegistry;
+        }
+
+        [[nodiscard]] ThreadBuffer& GetThreadBuffer()
+        {
+            static thread_local ThreadBuffer* sBuffer{ nullptr };
+            if (!sBuffer)
+            {
+                auto& registry{ GetRegistry() };
+                std::unique_lock<std::mutex> lock{ registry.mMutex };
+                auto& buffer{ registry.mBuffers.emplace_back(std::make_unique<ThreadBuffer>(std::this_thread::get_id())) };
+                buffer->mZones.reserve(1 << 12);
+                sBuffer = buffer.get();
+            }
+
+            return *sBuffer;
+        }
+    }
+
+    // Records the time between its construction and destruction on the calling thread, while tracing is on.
+    // Zones nest by time, so the viewer shows them as a hierarchy per thread.
+    // The name and category have to outlive the trace, string literals and the static day strings do.
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone(std::string_view name, std::string_view category = {})
+        {
+            if (trace::sIsEnabled.load(std::memory_order_relaxed))
+            {
+                mBuffer = &trace::GetThreadBuffer();
+                mName = name;
+                mCategory = category;
+                mStart = trace::Clock::now();
+            }
+        }
+
+        ~ScopedZone()
+        {
+            if (mBuffer)
+            {
+                mBuffer->mZones.emplace_back(mName, mCategory, mStart, trace::Clock::now());
+            }
+        }
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        trace::ThreadBuffer* mBuffer{ nullptr };
+        std::string_view mName;
+        std::string_view mCategory;
+        trace::Clock::time_point mStart;
+    };
+
+    // Zones recorded before are dropped, no other thread may be recording at this point.
+    void StartTracing()
+    {
+        auto& registry{ trace::GetRegistry() };
+        {
+            std::unique_lock<std::mutex> lock{ registry.mMutex };
+            for (auto& buffer : registry.mBuffers)
+            {
+                buffer->mZones.clear();
+            }
+            registry.mMainThreadId = std::this_thread::get_id();
+            registry.mStart = trace::Clock::now();
+        }
+        trace::sIsEnabled.store(true, std::memory_order_relaxed);
+    }
+
+    void StopTracing()
+    {
+        trace::sIsEnabled.store(false, std::memory_order_relaxed);
+    }
+
+    // Chrome trace event format, opens in chrome://tracing and in Perfetto. Every thread gets its own track,
+    // every zone is a complete event with its start and duration in microseconds since tracing started.
+    void WriteChromeTrace(std::ostream& outStream)
+    {
+        auto& registry{ trace::GetRegistry() };
+        std::unique_lock<std::mutex> lock{ registry.mMutex };
+        const auto toMicroseconds = [](trace::Clock::duration duration)
+            {
+                return std::chrono::duration<double, std::micro>(duration).count();
+            };
+
+        outStream << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n" << std::fixed << std::setprecision(3);
+        bool isFirst{ true };
+        for (const auto& [threadIndex, buffer] : registry.mBuffers | std::ranges::views::enumerate)
+        {
+            const bool isMainThread{ buffer->mThreadId == registry.mMainThreadId };
+            outStream << (isFirst ? "" : ",\n") << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << threadIndex
+                << ", \"args\": {\"name\": \"" << (isMainThread ? "main" : "thread ") << (isMainThread ? "" : std::to_string(threadIndex)) << "\"}}";
+            isFirst = false;
+
+            for (const auto& zone : buffer->mZones)
+            {
+                outStream << ",\n  {\"name\": \"" << EscapeJsonString(zone.mName) << "\", \"cat\": \"" << EscapeJsonString(zone.mCategory)
+                    << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << threadIndex
+                    << ", \"ts\": " << toMicroseconds(zone.mStart - registry.mStart)
+                    << ", \"dur\": " << toMicroseconds(zone.mEnd - zone.mStart) << '}';
+            }
+        }
+        outStream << "\n]}\n" << std::defaultfloat;
+    }
+}
@@ -3,17 +3,25 @@
 #include <string>
 #include <string_view>
 #include "DirectoryMacro.h"
+#include "InputGenerator.h"
+#include "MappedFile.h"
+#include "StreamReader.h"
+#include "NumberScanner.h"
 #include <concepts>
 #include <filesystem>
 #include <fstream>
 #include <ranges>
 #include <iostream>
 #include <unordered_map>
-#include <regex>
+#include <array>
+#include <span>
 #include <type_traits>
 #include <functional>
+#include <utility>
 #include <cstdint>
+#include <limits>
 #include <expected>
+#include <optional>
 
 class AbstractDay;
 
@@ -136,6 +144,7 @@ namespace utility
 
     constexpr std::string_view sReleaseFileName{ "input.txt" };
     constexpr std::string_view sTestFileName{ "test.txt" };
+    constexpr std::string_view sSyntheticFilePrefix{ "synthetic_" };
 
     template<utility::Integral T>
     T GetNumberOfDigitsByDivision(T number)
@@ -180,13 +189,28 @@ namespace utility
         return element1 * element2;
     }
 
+    // The digits of element2 appended to element1. Chains of concatenations easily run past T,
+    // that saturates at its maximum, which no checked result can be.
     template<utility::Integral T>
     T Concatenate(T element1, T element2)
     {
-        std::string num1{ std::to_string(element1) };
-        num1.append(std::to_string(element2));
+        assert(element1 >= T{} && element2 >= T{});
+        constexpr T maximum{ std::numeric_limits<T>::max() };
+        T shift{ 10 };
+        while (shift <= element2)
+        {
+            if (shift > maximum / 10)
+            {
+                return maximum;
+            }
+            shift *= 10;
+        }
 
-        return ToNumber<T>(num1);
+        if (element1 > (maximum - element2) / shift)
+        {
+            return maximum;
+        }
+        return element1 * shift + element2;
     }
 
     template<typename... T>
@@ -202,16 +226,25 @@ namespace utility
         both,
     };
 
+    enum class Phase
+    {
+        readInput,
+        first,
+        second,
+    };
+
     enum class InputVersion
     {
         release,
         test,
+        synthetic,
     };
 
     static const std::unordered_map<InputVersion, std::string_view> sInputVersionStringMap
     {
         {InputVersion::release, "Release"},
-        { InputVersion::test, "Test" }
+        { InputVersion::test, "Test" },
+        { InputVersion::synthetic, "Synthetic" }
     };
 
     static const std::unordered_map<Part, std::string_view> sPartStringMap
@@ -221,12 +254,28 @@ namespace utility
         {Part::both, "Both"}
     };
 
+    static const std::unordered_map<Phase, std::string_view> sPhaseStringMap
+    {
+        {Phase::readInput, "ReadInput"},
+        {Phase::first, "PerformFirst"},
+        {Phase::second, "PerformSecond"}
+    };
+
     template<IsDayAndHasDayString T, InputVersion sInputVersion = InputVersion::release>
     class InputReader
     {
     public:
-        [[nodiscard]] std::string Read() const
+        InputReader() = default;
+
+        explicit InputReader(const InputSource& source) : mSource{ source } {}
+
+        [[nodiscard]] std::filesystem::path GetPath() const
         {
+            if (!mSource.mPath.empty())
+            {
+                return mSource.mPath;
+            }
+
             std::filesystem::path path{ INPUT_DIR };
             path.append(T::sDay);
             switch (sInputVersion)
@@ -241,9 +290,48 @@ namespace utility
                 path /= sTestFileName;
             }
             break;
+            case InputVersion::synthetic:
+            {
+                const auto& settings{ GetSyntheticInputSettings() };
+                path /= std::string{ sSyntheticFilePrefix }.append(std::to_string(settings.mSize)).append("_").append(std::to_string(settings.mSeed))
+                    .append("_v").append(std::to_string(generator::sGeneratorVersion)).append(".txt");
+            }
+            break;
+            }
+
+            return path.make_preferred();
+        }
+
+        [[nodiscard]] std::optional<uintmax_t> GetSize() const
+        {
+            if (mSource.mIsStandardInput)
+            {
+                return {};
+            }
+
+            std::error_code errorCode;
+            const auto size{ std::filesystem::file_size(GetPath(), errorCode) };
+            if (errorCode)
+            {
+                return {};
+            }
+
+            return size;
+        }
+
+        [[nodiscard]] std::string Read() const
+        {
+            if (mSource.mIsStandardInput)
+            {
+                return { std::istreambuf_iterator<char>{ std::cin }, std::istreambuf_iterator<char>{} };
             }
 
-            if (std::ifstream inputReader{ path.make_preferred() ,std::ios::ate })
+            if constexpr (sInputVersion == InputVersion::synthetic)
+            {
+                Generate();
+            }
+
+            if (std::ifstream inputReader{ GetPath() ,std::ios::ate })
             {
                 const auto size{ inputReader.tellg() };
                 std::string result(size, '\0'); // use (), so we don't have to do narrowing conversion by hand. :(
@@ -254,6 +342,64 @@ namespace utility
 
             return {};
         };
+
+        // Zero copy alternative to Read, the returned mapping owns the memory the view points into.
+        [[nodiscard]] MappedFile Map() const
+        {
+            if (mSource.mIsStandardInput)
+            {
+                return MappedFile{ std::cin };
+            }
+
+            if constexpr (sInputVersion == InputVersion::synthetic)
+            {
+                Generate();
+            }
+
+            return MappedFile{ GetPath() };
+        }
+
+        // Streams the input record by record in chunks of the source's chunk size, the records don't outlive the callback.
+        template<typename Callback>
+        void ForEachRecord(std::string_view delimiter, Callback&& callback) const
+        {
+            if (mSource.mIsStandardInput)
+            {
+                ChunkedReader{ std::cin, delimiter, mSource.mChunkSize }.ForEachRecord(std::forward<Callback>(callback));
+                return;
+            }
+
+            if constexpr (sInputVersion == InputVersion::synthetic)
+            {
+                Generate();
+            }
+
+            if (std::ifstream inputReader{ GetPath(), std::ios::binary })
+            {
+                ChunkedReader{ inputReader, delimiter, mSource.mChunkSize }.ForEachRecord(std::forward<Callback>(callback));
+            }
+        }
+
+    private:
+        // Synthetic inputs are generated once per size and seed, later runs read the file again.
+        void Generate() const
+        {
+            if (!mSource.mPath.empty())
+            {
+                return;
+            }
+
+            const auto path{ GetPath() };
+            if (std::filesystem::exists(path))
+            {
+                return;
+            }
+
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream{ path, std::ios::binary } << generator::Generate(T::sDay, GetSyntheticInputSettings());
+        }
+
+        InputSource mSource;
     };
 
     [[nodiscard]] std::vector<std::string_view> GetStringSplitBy(const std::string& inputString, std::string_view delimiter = "\n")
@@ -278,61 +424,41 @@ namespace utility
         return static_cast<T>(inputData & 0x0F);
     }
 
+    // kept out of ToNumber, so the conversion stays small enough to inline
+    void ReportInvalidNumber(std::string_view inputData)
+    {
+        std::cout << "invalid input: " << inputData << '\n';
+        assert(false);
+    }
+
+    // For input that is known to be a number, TryToNumber tells what went wrong otherwise.
     template<Integral T = int32_t>
     [[nodiscard]] T ToNumber(std::string_view inputData)
     {
-        bool isNegative{ false };
-        if (inputData.front() == '-')
+        const auto result{ TryToNumber<T>(inputData) };
+        if (!result)
         {
-            isNegative = true;
-            inputData = inputData.substr(1);
+            ReportInvalidNumber(inputData);
+            return T{};
         }
 
-        T result{};
-        for (const char c : inputData)
-        {
-            if (c < '0' || c > '9')
-            {
-                std::cout << "invalid input: " << inputData << '\n';
-                break;
-            }
-            result *= 10;
-            result += static_cast<T>(c & 0x0F);
-        }
-
-        if (isNegative)
-        {
-            result *= -1;
-        }
-
-        return result;
+        return *result;
     }
 
+    // Every run of digits, with a minus right in front it's negative. Lines with more numbers than
+    // the stack buffer holds are scanned a second time, straight into the result.
     template<Integral T = int32_t>
     [[nodiscard]] std::vector<T> GetNumbers(std::string_view data)
     {
-        constexpr std::string_view sMatchExpression{ "\\d{1,}" };
-        std::regex baseRegex{ sMatchExpression.data() };
-
-        std::regex_token_iterator<std::string_view::iterator> endSentinelIterator;
-        std::regex_token_iterator<std::string_view::iterator> matchIterator{ data.begin(), data.end(), baseRegex };
-
-        std::vector<T> result;
-        result.reserve(2);
-        while (matchIterator != endSentinelIterator)
+        std::array<T, 16> buffer;
+        const auto count{ ScanNumbers(data, std::span{ buffer }) };
+        if (count <= buffer.size())
         {
-            if (matchIterator->first - 1 >= data.begin() && *(matchIterator->first - 1) == '-')
-            {
-                result.emplace_back(utility::ToNumber<T>(std::string_view{ matchIterator->first - 1, matchIterator->second }));
-            }
-            else
-            {
-                result.emplace_back(utility::ToNumber<T>(std::string_view{ matchIterator->first, matchIterator->second }));
-            }
-
-            matchIterator++;
+            return { buffer.begin(), buffer.begin() + count };
         }
 
+        std::vector<T> result(count);
+        std::ignore = ScanNumbers(data, std::span{ result });
         return result;
     }
 
@@ -479,29 +605,6 @@ namespace utility
         }
     };
 
-    enum class ErrorType
-    {
-        outOfBounds,
-    };
-
-    template<utility::IsMultiDimensionalRandomAccessRange T>
-    struct TwoDimensionalVectorType
-    {
-        using type = std::remove_cvref_t<std::remove_pointer_t<std::ranges::range_value_t<std::remove_cvref_t<std::remove_pointer_t<std::ranges::range_value_t<T>>>>>>;
-        using pointer_type = type*;
-    };
-
-    template<utility::IsMultiDimensionalRandomAccessRange T, SignedIntegral U>
-    std::expected<typename TwoDimensionalVectorType<T>::pointer_type, ErrorType> GetItemAt(T&& vector, Position<U> position)
-    {
-        if (position.mRow < 0 || position.mRow >= vector.size() || position.mCol < 0 || position.mCol >= vector[position.mRow].size())
-        {
-            return std::unexpected{ ErrorType::outOfBounds };
-        }
-
-        return &vector[position.mRow][position.mCol];
-    }
-
     enum class Direction
     {
         left,
@@ -515,37 +618,54 @@ namespace utility
     };
 
     using DirectionData = utility::Position<int32_t>;
-    static const std::unordered_map<Direction, DirectionData> sBaseDirectionsMap
-    {
-        {Direction::left,   {0,-1} },
-        {Direction::right,  {0,1}},
-        {Direction::up,     {-1, 0}},
-        {Direction::down,   {1, 0}},
+
+    // indexed by the value of the direction
+    static constexpr std::array<DirectionData, 8> sDirectionValues
+    {
+        DirectionData{0,-1},    // left
+        DirectionData{0,1},     // right
+        DirectionData{-1, 0},   // up
+        DirectionData{1, 0},    // down
+        DirectionData{-1,-1},   // leftUp
+        DirectionData{1,-1},    // leftDown
+        DirectionData{-1,1},    // rightUp
+        DirectionData{1, 1},    // rightDown
     };
 
-    static const std::unordered_map<Direction, DirectionData> sFullDirectionsMap
+    [[nodiscard]] constexpr DirectionData GetDirectionData(Direction direction)
     {
-        {Direction::left,   {0,-1} },
-        {Direction::right,  {0,1}},
-        {Direction::up,     {-1, 0}},
-        {Direction::down,   {1, 0}},
-        {Direction::leftUp, {-1,-1}},
-        {Direction::leftDown, {1,-1}},
-        {Direction::rightDown, {1, 1}},
-        {Direction::rightUp, {-1,1}},
-    };
+        return sDirectionValues[std::to_underlying(direction)];
+    }
+
+    static_assert(GetDirectionData(Direction::up).mRow == -1 && GetDirectionData(Direction::up).mCol == 0);
+    static_assert(GetDirectionData(Direction::rightDown).mRow == 1 && GetDirectionData(Direction::rightDown).mCol == 1);
 
-    static constexpr std::array<std::pair<DirectionData, Direction>, 8> sFullReverseDirectionsArray
+    // The neighbours of a cell, visited in the order of the array.
+    static constexpr std::array<Direction, 4> sBaseDirections{ Direction::left, Direction::right, Direction::up, Direction::down };
+    static constexpr std::array<Direction, 8> sFullDirections{ Direction::left, Direction::right, Direction::up, Direction::down,
+        Direction::leftUp, Direction::leftDown, Direction::rightUp, Direction::rightDown };
+
+    // Calls function(direction, neighbour) for every direction of the stencil. The loop is unrolled at compile time
+    // and every offset is a constant.
+    template<const auto& stencil, SignedIntegral T, typename Function>
+    constexpr void ForEachNeighbor(Position<T> position, Function&& function)
     {
-        std::pair<DirectionData,Direction>{{0,-1},Direction::left },
-        {{0,1}, Direction::right},
-        {{-1, 0}, Direction::up},
-        {{1, 0}, Direction::down},
-        {{-1,-1}, Direction::leftUp},
-        {{1,-1}, Direction::leftDown},
-        {{1, 1}, Direction::rightDown},
-        {{-1,1}, Direction::rightUp},
-    };
+        [&]<size_t... index>(std::index_sequence<index...>)
+        {
+            (function(stencil[index], Position<T>{ static_cast<T>(position.mRow + GetDirectionData(stencil[index]).mRow),
+                static_cast<T>(position.mCol + GetDirectionData(stencil[index]).mCol) }), ...);
+        }(std::make_index_sequence<stencil.size()>{});
+    }
+
+    // Same for linear indices into a grid with rows stride cells apart.
+    template<const auto& stencil, SignedIntegral T, typename Function>
+    constexpr void ForEachNeighbor(T index, T stride, Function&& function)
+    {
+        [&]<size_t... directionIndex>(std::index_sequence<directionIndex...>)
+        {
+            (function(stencil[directionIndex], static_cast<T>(index + GetDirectionData(stencil[directionIndex]).mRow * stride + GetDirectionData(stencil[directionIndex]).mCol)), ...);
+        }(std::make_index_sequence<stencil.size()>{});
+    }
 
     static constexpr std::array<Direction, 4> sBaseDirectionOrder{ Direction::up, Direction::right, Direction::down, Direction::left };
     static constexpr std::array<Position<int32_t>, 4> sBaseDirectionValuesInOrder{
@@ -593,17 +713,6 @@ namespace utility
         return sBaseDirectionValuesInOrder[GetNextDirectionIndex(direction)];
     }
 
-    DirectionData GetDirectionData(Direction direction)
-    {
-        if (auto directionIterator{ sFullDirectionsMap.find(direction) }; directionIterator != sFullDirectionsMap.end())
-        {
-            return directionIterator->second;
-        }
-
-        assert(false);
-        return {};
-    }
-
     template<typename... T>
     void PrintResult(T&&... args)
     {
@@ -1,4 +1,5 @@
 #include "Utility.h"
+#include "DayRegistry.h"
 #include "Day1.h"
 #include "Day2.h"
 #include "Day3.h"
@@ -16,38 +17,148 @@
 #include "Day15.h"
 #include "Day16.h"
 
-int main()
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
 {
-    //DayWrapper<Day1> d1;
-    //d1.Perform();
-    //DayWrapper<Day2> d2;
-    //d2.Perform();
-    //DayWrapper<Day3> d3;
-    //d3.Perform();
-    //DayWrapper<Day4> d4;
-    //d4.Perform();
-    //DayWrapper<Day5> d5;
-    //d5.Perform();
-    //DayWrapper<Day6> d6;
-    //d6.Perform();
-    //DayWrapper<Day7> d7;
-    //d7.Perform();
-    //DayWrapper<Day8> d8;
-    //d8.Perform();
-    //DayWrapper<Day9> d9;
-    //d9.Perform();
-    //DayWrapper<Day10> d10;
-    //d10.Perform();
-    //DayWrapper<Day11> d11;
-    //d11.Perform();
-    //DayWrapper<Day12> d12;
-    //d12.Perform();
-    //DayWrapper<Day13> d13;
-    //d13.Perform();
-    //DayWrapper<Day14> d14;
-    //d14.Perform();
-    DayWrapper<Day15> d15;
-    d15.Perform();
-    //DayWrapper<Day16> d16;
-    //d16.Perform();
+    auto options{ utility::ParseCommandLine(argc, argv) };
+    if (!options.has_value())
+    {
+        std::cerr << options.error() << '\n';
+        utility::PrintUsage(std::cerr);
+        return 1;
+    }
+
+    const auto registry{ MakeDayRegistry<Day1, Day2, Day3, Day4, Day5, Day6, Day7, Day8,
+        Day9, Day10, Day11, Day12, Day13, Day14, Day15, Day16>() };
+
+    if (options->mShowHelp)
+    {
+        utility::PrintUsage(std::cout);
+        return 0;
+    }
+
+    if (options->mListDays)
+    {
+        registry.PrintDays(std::cout);
+        return 0;
+    }
+
+    if (!options->mAllDays && options->mDays.empty())
+    {
+        utility::PrintUsage(std::cerr);
+        return 1;
+    }
+
+    // an explicitly given answers file has to exist, the default one is optional
+    const auto expectedAnswersPath{ options->mExpectedAnswersPath.empty() ? utility::GetDefaultExpectedAnswersPath() : options->mExpectedAnswersPath };
+    if (!options->mExpectedAnswersPath.empty() || std::filesystem::exists(expectedAnswersPath))
+    {
+        auto expectedAnswers{ utility::LoadExpectedAnswers(expectedAnswersPath) };
+        if (!expectedAnswers.has_value())
+        {
+            std::cerr << expectedAnswers.error() << '\n';
+            return 1;
+        }
+
+        options->mExpectedAnswers = std::move(*expectedAnswers);
+    }
+
+    if (!options->mBatchPath.empty())
+    {
+        auto batchInputs{ utility::CollectBatchInputs(options->mBatchPath) };
+        if (!batchInputs.has_value())
+        {
+            std::cerr << batchInputs.error() << '\n';
+            return 1;
+        }
+
+        options->mBatchInputs = std::move(*batchInputs);
+    }
+
+    if (!options->mTracePath.empty())
+    {
+        utility::StartTracing();
+    }
+
+    // malformed input, e.g. a grid with rows of different length, is thrown out of the day reading it
+    std::optional<utility::RunReport> report;
+    try
+    {
+        report = registry.Perform(*options);
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    if (!report)
+    {
+        return 1;
+    }
+
+    if (!options->mTracePath.empty())
+    {
+        utility::StopTracing();
+        std::ofstream traceFile{ options->mTracePath };
+        if (!traceFile)
+        {
+            std::cerr << "couldn't open " << options->mTracePath << " for writing\n";
+            return 1;
+        }
+
+        utility::WriteChromeTrace(traceFile);
+    }
+
+    const auto& records{ report->mRecords };
+
+    if (options->mOutput.mFormat != utility::OutputFormat::text)
+    {
+        if (options->mOutput.mPath.empty())
+        {
+            utility::WriteRecords(std::cout, options->mOutput.mFormat, records);
+        }
+        else if (std::ofstream outputFile{ options->mOutput.mPath })
+        {
+            utility::WriteRecords(outputFile, options->mOutput.mFormat, records);
+        }
+        else
+        {
+            std::cerr << "couldn't open " << options->mOutput.mPath << " for writing\n";
+            return 1;
+        }
+    }
+
+    if (report->mCheckedAnswerCount > 0)
+    {
+        utility::GetLogStream(*options) << "Checked " << report->mCheckedAnswerCount << " answer(s), " << report->mWrongAnswerCount << " wrong\n";
+    }
+
+    const auto& regressionOptions{ options->mRegression };
+    if (!regressionOptions.mSaveBaselinePath.empty() && !utility::SaveBaseline(regressionOptions.mSaveBaselinePath, records))
+    {
+        std::cerr << "couldn't write baseline " << regressionOptions.mSaveBaselinePath << '\n';
+        return 1;
+    }
+
+    if (!regressionOptions.mCompareBaselinePath.empty())
+    {
+        const auto baseline{ utility::LoadBaseline(regressionOptions.mCompareBaselinePath) };
+        if (!baseline.has_value())
+        {
+            std::cerr << baseline.error() << '\n';
+            return 1;
+        }
+
+        if (const auto regressions{ utility::CompareToBaseline(utility::GetLogStream(*options), *baseline, records, regressionOptions) }; regressions > 0)
+        {
+            std::cerr << regressions << " phase(s) regressed\n";
+            return 2;
+        }
+    }
+
+    return report->mWrongAnswerCount > 0 ? 3 : 0;
 }
\ No newline at end of file